@@ -1,77 +1,277 @@
 #include "AdjacencyList.h"
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <random>
+#include <vector>
+#include <charconv>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 //This source code is original, but I did look here for reference:
 //https://www.programiz.com/dsa/graph-adjacency-list
 
+//Binary .bgraph layout, all little endian:
+//64 byte header, then (numVertices + 1) uint64 CSR offsets, then offsets[numVertices] neighbor ids of idWidth bytes
+//The arrays start 8 byte aligned so a mapped file can be used in place
+struct BinaryGraphHeader
+{
+    char magic[8]; //"CSRGRAPH"
+    uint32_t version;
+    uint32_t idWidth; //bytes per neighbor id
+    uint64_t numVertices;
+    uint64_t numEdges; //undirected edges are counted once
+    uint32_t directed;
+    uint32_t sorted; //1 if every row is in increasing order
+    char reserved[24];
+};
+
+static_assert(sizeof(BinaryGraphHeader) == 64, "binary graph header must be 64 bytes");
+static_assert(sizeof(size_t) == sizeof(uint64_t), "CSR offsets are stored as uint64");
+
+static const char BINARY_MAGIC[8] = {'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H'};
+static const uint32_t BINARY_VERSION = 1;
+
 AdjacencyList::AdjacencyList(size_t numVertices, bool isDirected)
 {
     //Creates a graph with specified num of vertices, with no edges
     vertices = new Node[numVertices]();
-    degreeList = new LinkedList<int>[numVertices](); //index represents degree of children
-    edges = new bool[numVertices*numVertices](); //index |V|*v1 + v2 is true if v1->v2 is an edge
+    neighborPool = new NodePool<int>();
+    edgeSet = new PairSet();
     directed = isDirected;
     size = numVertices;
 
     for (size_t i = 0; i < numVertices; i++)
+    {
         vertices[i].id = i;
+        vertices[i].neighbors.setPool(neighborPool);
+    }
 
 }
 
-AdjacencyList::AdjacencyList(std::string filename, bool isDirected)
+static bool isSpace(char c)
 {
-    //Construct an adjacency list from an input file
-    std::ifstream file(filename);
-    size_t numVertices;
-    int currentLine = 2;
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
 
-    //Read in size and starting positions and initialize adj list members
-    file >> numVertices;
-    size = numVertices;
+static const char* parseNumber(const char* p, const char* end, long long& value)
+{
+    //Parses the next integer after any whitespace, returns nullptr if there isn't one
+    while (p < end && isSpace(*p))
+        p++;
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc())
+        return nullptr;
+    return result.ptr;
+}
 
+AdjacencyList::AdjacencyList(std::string filename, bool isDirected, size_t numThreads)
+{
+    //Construct an adjacency list from an input file
+    //The edge lines are already in CSR order, with startingPos marking where each vertex begins,
+    //so the file is mapped and several threads parse its edge section straight into the CSR arrays
+    GRAPH_PHASE(stats.construction);
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open " + filename);
+
+    struct stat st;
+    fstat(fd, &st);
+    size_t length = st.st_size;
+    void* data = length > 0 ? mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (data == MAP_FAILED)
+        throw std::runtime_error("Cannot map " + filename);
+    madvise(data, length, MADV_SEQUENTIAL);
+
+    const char* p = (const char*)data;
+    const char* end = p + length;
+    while (end > p && isSpace(end[-1])) //trailing newline(s), so the last line is the last number
+        end--;
+
+    //Every check below runs before vertices and the neighbor pool are allocated, and frees the CSR arrays it has so far,
+    //since the destructor does not run for a constructor that throws
+    const char** bounds = nullptr;
+    size_t* chunkStart = nullptr;
+    auto fail = [&](const std::string& problem) {
+        munmap(data, length);
+        delete[] bounds;
+        delete[] chunkStart;
+        delete[] offsets;
+        delete[] adjacency;
+        offsets = nullptr;
+        adjacency = nullptr;
+        throw std::runtime_error(filename + problem);
+    };
+
+    //Read in size and starting positions, every vertex has a starting position line so the file bounds the size
+    long long numVertices;
+    p = parseNumber(p, end, numVertices);
+    if (p == nullptr || numVertices < 0 || (unsigned long long)numVertices > length / 2)
+        fail(" is not a graph file");
+    size = numVertices;
     directed = isDirected;
-    vertices = new Node[numVertices]();
-    degreeList = new LinkedList<int>[numVertices](); //index represents degree of children
-    edges = new bool[numVertices*numVertices]();
-    for (size_t i = 0; i < numVertices; i++)
-        vertices[i].id = i;
 
-    int* startingPos = new int[size];
-    for (int i = 0; i < size; i++)
+    size_t firstEdgeLine = 1 + size + 1;
+    offsets = new size_t[size + 1];
+    for (size_t i = 0; i < size; i++)
     {
-        int pos;
-        file >> pos;
-        startingPos[i] = pos;
-        currentLine++;
+        long long pos;
+        p = (p == nullptr) ? nullptr : parseNumber(p, end, pos);
+        if (p == nullptr || pos < (long long)firstEdgeLine || (i > 0 && pos - firstEdgeLine < offsets[i - 1]))
+            fail(" has a bad starting position for vertex " + std::to_string(i));
+        offsets[i] = pos - firstEdgeLine;
     }
-
-    //Read in the edges
-    for (int i = 0; i < size; i++)
+    while (p < end && isSpace(*p))
+        p++;
+
+    //Split the edge section into chunks that start on a line boundary and count the lines in each,
+    //a prefix sum over the counts then tells every chunk where its lines go in the CSR array
+    ThreadPool threads(numThreads);
+    size_t numChunks = (end - p > (1 << 20)) ? threads.size() * 4 : 1;
+    bounds = new const char*[numChunks + 1];
+    chunkStart = new size_t[numChunks + 1];
+    bounds[0] = p;
+    bounds[numChunks] = end;
+    for (size_t k = 1; k < numChunks; k++)
     {
-        while (currentLine < startingPos[i + 1])
+        const char* b = p + (end - p) * k / numChunks;
+        b = std::max(b, bounds[k - 1]);
+        while (b < end && b[-1] != '\n')
+            b++;
+        bounds[k] = b;
+    }
+
+    threads.parallelFor(numChunks, 1, [&](size_t begin, size_t, size_t) {
+        chunkStart[begin + 1] = std::count(bounds[begin], bounds[begin + 1], '\n');
+    });
+    chunkStart[0] = 0;
+    if (p < end)
+        chunkStart[numChunks]++; //the last line has no newline after trimming
+    for (size_t k = 0; k < numChunks; k++)
+        chunkStart[k + 1] += chunkStart[k];
+
+    size_t numEntries = chunkStart[numChunks];
+    offsets[size] = numEntries;
+    if (size > 0 && offsets[size - 1] > numEntries)
+        fail(" is truncated");
+
+    adjacency = new int[numEntries];
+    std::atomic<bool> malformed(false);
+    threads.parallelFor(numChunks, 1, [&](size_t k, size_t, size_t) {
+        const char* q = bounds[k];
+        for (size_t j = chunkStart[k]; j < chunkStart[k + 1]; j++)
         {
-            int v2;
-            file >> v2;
-            addEdge(i, v2);
-            currentLine++;
+            long long v;
+            q = parseNumber(q, bounds[k + 1], v);
+            if (q == nullptr || v < 0 || v >= (long long)size)
+            {
+                malformed = true;
+                return;
+            }
+            adjacency[j] = v;
         }
+    });
+    if (malformed)
+        fail(" has a malformed edge line");
+
+    munmap(data, length);
+    delete[] bounds;
+    delete[] chunkStart;
+
+    vertices = new Node[size]();
+    neighborPool = new NodePool<int>();
+    for (size_t i = 0; i < size; i++)
+    {
+        vertices[i].id = i;
+        vertices[i].neighbors.setPool(neighborPool);
     }
 
-    file.close();
-    delete[] startingPos;
+    //Rows written by save() are sorted already, anything else is sorted here
+    threads.parallelFor(size, 1024, [&](size_t begin, size_t stop, size_t) {
+        for (size_t i = begin; i < stop; i++)
+            if (!std::is_sorted(adjacency + offsets[i], adjacency + offsets[i + 1]))
+                std::sort(adjacency + offsets[i], adjacency + offsets[i + 1]);
+    });
 
-    genDegreeList();
+    frozen = true;
+    buildIndex(EdgeIndex::AUTO);
 }
 
 AdjacencyList::~AdjacencyList()
 {
     delete[] vertices;
-    delete[] degreeList;
-    delete[] edges;
+    delete neighborPool; //after vertices, the lists leave their nodes to the pool
+    delete edgeSet;
+    releaseCsr();
+    delete dense;
+    delete threadPool;
+    delete workspace;
+    stopDynamicColoring();
+}
+
+AdjacencyList::AdjacencyList(AdjacencyList&& other) noexcept: rng(other.rng)
+{
+    //Takes over every array of other and leaves it with none, so its destructor frees nothing
+    vertices = std::exchange(other.vertices, nullptr);
+    neighborPool = std::exchange(other.neighborPool, nullptr);
+    directed = other.directed;
+    size = std::exchange(other.size, 0);
+
+    frozen = std::exchange(other.frozen, false);
+    offsets = std::exchange(other.offsets, nullptr);
+    adjacency = std::exchange(other.adjacency, nullptr);
+    mapping = std::exchange(other.mapping, nullptr);
+    mappingLength = std::exchange(other.mappingLength, 0);
+    edgeSet = std::exchange(other.edgeSet, nullptr);
+    dense = std::exchange(other.dense, nullptr);
+
+    threadPool = std::exchange(other.threadPool, nullptr);
+    workspace = std::exchange(other.workspace, nullptr);
+    numThreads = other.numThreads;
+    phaseTimes = other.phaseTimes;
+    report = other.report;
+    asyncOutput = other.asyncOutput;
+    stats = other.stats;
+
+    dynamic = std::exchange(other.dynamic, false);
+    dynamicAlgorithm = other.dynamicAlgorithm;
+    recolorThreshold = other.recolorThreshold;
+    kempeLimit = other.kempeLimit;
+    classSize = std::exchange(other.classSize, nullptr);
+    topColor = other.topColor;
+    baselineColors = other.baselineColors;
+    fullRecolors = other.fullRecolors;
+    colorStamp = std::exchange(other.colorStamp, nullptr);
+    colorWitness = std::exchange(other.colorWitness, nullptr);
+    visitStamp = std::exchange(other.visitStamp, nullptr);
+    stamp = other.stamp;
+}
+
+AdjacencyList& AdjacencyList::operator=(AdjacencyList&& other) noexcept
+{
+    //Frees what this graph holds and takes over other the same way the move constructor does
+    if (this != &other)
+    {
+        this->~AdjacencyList();
+        new (this) AdjacencyList(std::move(other));
+    }
+    return *this;
 }
 
 AdjacencyList AdjacencyList::createCycle(size_t numVertices)
 {
     AdjacencyList adj(numVertices);
+    GRAPH_PHASE(adj.stats.construction);
     for (size_t i = 0; i < numVertices - 1; i++)
         adj.addEdge(i, i+1);
     adj.addEdge(numVertices - 1, 0);
@@ -81,56 +281,341 @@ AdjacencyList AdjacencyList::createCycle(size_t numVertices)
 
 AdjacencyList AdjacencyList::createCompleteGraph(size_t numVertices)
 {
-    AdjacencyList adj(numVertices, true); //init as directed graph to make creation easier
+    //Built straight into the frozen dense form, every row is all ones except the diagonal
+    AdjacencyList adj(numVertices);
+    GRAPH_PHASE(adj.stats.construction);
+    delete adj.edgeSet;
+    adj.edgeSet = nullptr;
+
+    adj.dense = new BitMatrix(numVertices);
     for (size_t i = 0; i < numVertices; i++)
         for (size_t j = 0; j < numVertices; j++)
             if (i != j)
-                adj.addEdge(i, j);
+                adj.dense->set(i, j);
 
-    adj.directed = false; //change back to undirected
+    adj.buildFromDense();
     
     return adj;
 }
 
 AdjacencyList AdjacencyList::createRandomGraph(size_t numVertices, size_t numEdges, AdjacencyList::Distribution dist)
 {
-    RandomGen rg(numVertices - 1);
-    AdjacencyList adj(numVertices);
+    Rng rng;
+    return createRandomGraph(numVertices, numEdges, dist, rng);
+}
+
+//Vitter's method D: appends numSamples distinct indices of [0, total) to out in increasing order
+//Each step draws the gap to the next chosen index, so the cost is proportional to numSamples rather than total.
+//Once the samples make up more than 1/13 of what is left it switches to method A, which is then just as cheap
+static void sampleSorted(uint64_t total, uint64_t numSamples, RandomGen& rg, std::vector<uint64_t>& out)
+{
+    const double alphaInv = 13;
+    uint64_t current = 0;
+    double n = numSamples;
+    double N = total;
+
+    if (numSamples == 0)
+        return;
+
+    double nInv = 1.0 / n;
+    double vPrime = exp(log(rg.randRealUniform()) * nInv);
+    double qu1 = N - n + 1;
+    double threshold = alphaInv * n;
+
+    while (n > 1 && threshold < N)
+    {
+        double nMin1Inv = 1.0 / (n - 1);
+        double S;
+        while (true)
+        {
+            double X;
+            while (true)
+            {
+                X = N * (1 - vPrime);
+                S = floor(X);
+                if (S < qu1)
+                    break;
+                vPrime = exp(log(rg.randRealUniform()) * nInv);
+            }
+
+            double U = rg.randRealUniform();
+            double y1 = exp(log(U * N / qu1) * nMin1Inv);
+            vPrime = y1 * (1 - X / N) * (qu1 / (qu1 - S));
+            if (vPrime <= 1)
+                break;
+
+            double y2 = 1;
+            double top = N - 1;
+            double bottom, limit;
+            if (n - 1 > S)
+            {
+                bottom = N - n;
+                limit = N - S;
+            }
+            else
+            {
+                bottom = N - S - 1;
+                limit = qu1;
+            }
+            for (double t = N - 1; t >= limit; t--)
+            {
+                y2 = (y2 * top) / bottom;
+                top--;
+                bottom--;
+            }
+
+            if (N / (N - X) >= y1 * exp(log(y2) * nMin1Inv))
+            {
+                vPrime = exp(log(rg.randRealUniform()) * nMin1Inv);
+                break;
+            }
+            vPrime = exp(log(rg.randRealUniform()) * nInv);
+        }
+
+        current += (uint64_t)S;
+        out.push_back(current++);
+        N = N - S - 1;
+        n--;
+        nInv = nMin1Inv;
+        qu1 -= S;
+        threshold -= alphaInv;
+    }
 
-    int edgeCount = 0; //keep track of how many edges are successfully created
-    while (edgeCount < numEdges)
+    if (n > 1)
     {
-        //Generate random pair of vertices
-        int v1, v2;
-        if (dist == AdjacencyList::Distribution::UNIFORM)
+        //Method A
+        double top = N - n;
+        while (n >= 2)
         {
-            v1 = rg.randUniform();
-            v2 = rg.randUniform();
+            double V = rg.randRealUniform();
+            double quot = top / N;
+            uint64_t S = 0;
+            while (quot > V)
+            {
+                S++;
+                top--;
+                N--;
+                quot = quot * top / N;
+            }
+            current += S;
+            out.push_back(current++);
+            N--;
+            n--;
         }
-        else if (dist == AdjacencyList::Distribution::SKEWED)
+        current += (uint64_t)floor(N * rg.randRealUniform());
+        out.push_back(current);
+    }
+    else
+    {
+        current += (uint64_t)floor(N * vPrime);
+        out.push_back(current);
+    }
+}
+
+static std::vector<uint64_t> rejectionEdges(size_t numVertices, size_t numEdges, AdjacencyList::Distribution dist, Rng& rng, size_t numThreads)
+{
+    //Parallel rejection sampler, the result only depends on the state of rng
+    //The draws are split over a fixed number of streams, each a split of rng, and the workers share the streams out,
+    //so the number of threads only changes the speed. Every round each stream draws its share of the missing edges
+    //and sorts them, the batches are merged and deduplicated in parallel, and whatever is new is merged into the
+    //accepted edges. Duplicates only shrink a round, so the next round tops up the shortfall
+    const size_t numStreams = 64;
+    ThreadPool threads(numThreads);
+    RandomGen** streams = new RandomGen*[numStreams];
+    for (size_t k = 0; k < numStreams; k++)
+        streams[k] = new RandomGen(numVertices - 1, rng.split());
+
+    std::vector<uint64_t> accepted; //sorted, unique, packed (min, max) pairs
+    std::vector<std::vector<uint64_t>> batches(numStreams);
+    while (accepted.size() < numEdges)
+    {
+        size_t missing = numEdges - accepted.size();
+        threads.parallelFor(numStreams, 1, [&](size_t k, size_t, size_t) {
+            size_t quota = missing / numStreams + (k < missing % numStreams ? 1 : 0);
+            RandomGen& rg = *streams[k];
+            std::vector<uint64_t>& batch = batches[k];
+            batch.clear();
+            std::vector<int> draws;
+            while (batch.size() < quota)
+            {
+                //Generate random pairs of vertices a block at a time, draws[2i] and draws[2i + 1] form a pair
+                size_t pairs = std::min(quota - batch.size(), (size_t)2048);
+                draws.resize(2 * pairs);
+                if (dist == AdjacencyList::Distribution::UNIFORM)
+                {
+                    for (size_t i = 0; i < draws.size(); i++)
+                        draws[i] = rg.randUniform();
+                }
+                else if (dist == AdjacencyList::Distribution::SKEWED)
+                    rg.fillSkewed(draws.data(), draws.size());
+                else
+                    rg.fillNormal(draws.data(), draws.size());
+
+                for (size_t i = 0; i < pairs; i++)
+                {
+                    int v1 = draws[2 * i];
+                    int v2 = draws[2 * i + 1];
+                    if (v1 != v2)
+                        batch.push_back(PairSet::pack(std::min(v1, v2), std::max(v1, v2)));
+                }
+            }
+            std::sort(batch.begin(), batch.end());
+        });
+
+        //Merge the sorted batches pairwise in parallel until one is left
+        for (size_t step = 1; step < numStreams; step *= 2)
         {
-            v1 = rg.randSkewed();
-            v2 = rg.randSkewed();
+            threads.parallelFor(numStreams, 1, [&](size_t w, size_t, size_t) {
+                if (w % (2 * step) != 0 || w + step >= numStreams)
+                    return;
+                std::vector<uint64_t> merged(batches[w].size() + batches[w + step].size());
+                std::merge(batches[w].begin(), batches[w].end(), batches[w + step].begin(), batches[w + step].end(), merged.begin());
+                batches[w].swap(merged);
+                batches[w + step].clear();
+            });
         }
-        else
+
+        std::vector<uint64_t>& candidates = batches[0];
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        std::vector<uint64_t> fresh;
+        std::set_difference(candidates.begin(), candidates.end(), accepted.begin(), accepted.end(), std::back_inserter(fresh));
+        size_t oldSize = accepted.size();
+        accepted.insert(accepted.end(), fresh.begin(), fresh.end());
+        std::inplace_merge(accepted.begin(), accepted.begin() + oldSize, accepted.end());
+    }
+
+    for (size_t k = 0; k < numStreams; k++)
+        delete streams[k];
+    delete[] streams;
+
+    return accepted;
+}
+
+static std::vector<uint64_t> gnmEdges(size_t numVertices, size_t numEdges, Rng& rng)
+{
+    //Exactly numEdges distinct pairs chosen uniformly, in O(V + E)
+    //Edge indices count the pairs (u, v), u < v, row by row, so sorted indices map to sorted pairs
+    RandomGen rg(numVertices - 1, rng.split());
+    std::vector<uint64_t> edges;
+    edges.reserve(numEdges);
+    sampleSorted(numVertices * (numVertices - 1) / 2, numEdges, rg, edges);
+
+    uint64_t u = 0;
+    uint64_t rowStart = 0;
+    for (uint64_t& e : edges)
+    {
+        while (e >= rowStart + (numVertices - 1 - u))
         {
-            v1 = rg.randNormal();
-            v2 = rg.randNormal();
+            rowStart += numVertices - 1 - u;
+            u++;
         }
+        e = PairSet::pack(u, u + 1 + (e - rowStart));
+    }
+
+    return edges;
+}
+
+AdjacencyList AdjacencyList::createRandomGraph(size_t numVertices, size_t numEdges, AdjacencyList::Distribution dist, Rng& rng, size_t numThreads)
+{
+    if (numVertices < 2 || numEdges > numVertices * (numVertices - 1) / 2)
+        throw std::invalid_argument("Too many edges for the number of vertices");
+
+    AdjacencyList adj(numVertices);
+    GRAPH_PHASE(adj.stats.construction);
+
+    //Uniform pairs need no rejection, the edges are sampled directly from the edge index space
+    std::vector<uint64_t> edges;
+    if (dist == AdjacencyList::Distribution::UNIFORM)
+        edges = gnmEdges(numVertices, numEdges, rng);
+    else
+        edges = rejectionEdges(numVertices, numEdges, dist, rng, numThreads);
 
-        if (v1 != v2 && v1 < numVertices && v2 < numVertices)
+    adj.loadSortedEdges(edges.data(), edges.size());
+    return adj;
+}
+
+AdjacencyList AdjacencyList::createGnm(size_t numVertices, size_t numEdges, Rng& rng)
+{
+    //Exactly numEdges edges chosen uniformly, in O(V + E)
+    if (numVertices < 2 || numEdges > numVertices * (numVertices - 1) / 2)
+        throw std::invalid_argument("Too many edges for the number of vertices");
+
+    AdjacencyList adj(numVertices);
+    GRAPH_PHASE(adj.stats.construction);
+    std::vector<uint64_t> edges = gnmEdges(numVertices, numEdges, rng);
+    adj.loadSortedEdges(edges.data(), edges.size());
+    return adj;
+}
+
+AdjacencyList AdjacencyList::createGnp(size_t numVertices, double p, Rng& rng)
+{
+    //Every pair is an edge independently with probability p, in O(V + E)
+    //Batagelj-Brandes: the gap to the next edge is geometric, so it is drawn directly instead of testing every pair
+    if (p < 0 || p > 1)
+        throw std::invalid_argument("Edge probability must be in [0, 1]");
+
+    AdjacencyList adj(numVertices);
+    GRAPH_PHASE(adj.stats.construction);
+    std::vector<uint64_t> edges;
+    if (numVertices >= 2 && p > 0)
+    {
+        RandomGen rg(numVertices - 1, rng.split());
+        double logQ = log(1 - p);
+        edges.reserve((size_t)(p * numVertices * (numVertices - 1) / 2 * 1.05) + 16);
+
+        //Walks the pairs (u, v), u < v, row by row, v = u means just before the first pair of the row
+        uint64_t u = 0;
+        uint64_t v = 0;
+        while (true)
         {
-            if (!adj.hasEdge(v1, v2))
+            uint64_t skip = (p == 1) ? 0 : (uint64_t)std::min(floor(log(1 - rg.randRealUniform()) / logQ), 1e18);
+            v += 1 + skip;
+            while (u < numVertices - 1 && v >= numVertices)
             {
-                adj.addEdge(v1, v2);
-                edgeCount++;
+                v = v - numVertices + u + 2;
+                u++;
             }
+            if (u >= numVertices - 1)
+                break;
+            edges.push_back(PairSet::pack(u, v));
         }
-
     }
 
+    adj.loadSortedEdges(edges.data(), edges.size());
     return adj;
+}
+
+void AdjacencyList::loadSortedEdges(const uint64_t* edges, size_t numEdges)
+{
+    //Builds the frozen CSR arrays of an empty undirected graph from sorted, unique, packed (v1 < v2) pairs
+    //Row v gets its smaller neighbors first and then its larger ones, both in increasing order,
+    //so the rows come out sorted without another pass
+    offsets = new size_t[size + 1]();
+    for (size_t e = 0; e < numEdges; e++)
+    {
+        offsets[(edges[e] >> 32) + 1]++;
+        offsets[(uint32_t)edges[e] + 1]++;
+    }
+    for (size_t i = 0; i < size; i++)
+        offsets[i + 1] += offsets[i];
 
+    adjacency = new int[offsets[size]];
+    size_t* next = new size_t[size];
+    std::copy(offsets, offsets + size, next);
+    for (size_t e = 0; e < numEdges; e++)
+    {
+        int v1 = edges[e] >> 32;
+        int v2 = (uint32_t)edges[e];
+        adjacency[next[v1]++] = v2;
+        adjacency[next[v2]++] = v1;
+    }
+    delete[] next;
+
+    delete edgeSet;
+    edgeSet = nullptr;
+    frozen = true;
+    buildIndex(EdgeIndex::AUTO);
 }
 
 void AdjacencyList::Node::addNeighbor(int id)
@@ -138,11 +623,35 @@ void AdjacencyList::Node::addNeighbor(int id)
     neighbors.push_back(id);
 }
 
+void AdjacencyList::Node::removeNeighbor(int id)
+{
+    for (auto iter = neighbors.begin(); !iter.isEnd(); iter++)
+    {
+        if (*iter == id)
+        {
+            neighbors.erase(iter);
+            return;
+        }
+    }
+}
+
 bool AdjacencyList::hasEdge(int v1, int v2) const
 {
-    int edgeIndex = size * v1 + v2; //index in edge existence table - for v1->v2
-    int edgeIndexReverse = size * v2 + v1; //for v2->v1
-    return (edges[edgeIndex] || (!directed && edges[edgeIndexReverse]));
+    GRAPH_COUNT(stats.edgeProbes, 1);
+    if (dense != nullptr)
+        return dense->test(v1, v2);
+
+    if (edgeSet != nullptr)
+    {
+        if (directed)
+            return edgeSet->contains(v1, v2);
+        return edgeSet->contains(std::min(v1, v2), std::max(v1, v2));
+    }
+
+    //Sorted CSR rows - search the shorter row when the edge can be stored either way
+    if (!directed && degree(v2) < degree(v1))
+        std::swap(v1, v2);
+    return std::binary_search(adjacency + offsets[v1], adjacency + offsets[v1 + 1], v2);
 }
 
 void AdjacencyList::addEdge(int v1, int v2)
@@ -153,16 +662,199 @@ void AdjacencyList::addEdge(int v1, int v2)
     if (v1 > size - 1 || v2 > size - 1)
         throw std::out_of_range("Invalid vertex input");
 
-    //Update edges table
+    //The CSR arrays are immutable, so go back to per-vertex lists first
+    if (frozen)
+        thaw();
+
+    //Update edge index, an edge that already exists is ignored
+    GRAPH_COUNT(stats.edgeProbes, 1);
+    bool added = directed ? edgeSet->insert(v1, v2) : edgeSet->insert(std::min(v1, v2), std::max(v1, v2));
+    if (!added)
+        return;
+
     vertices[v1].addNeighbor(v2);
     if (!directed) //undirected graph means edge goes both ways
         vertices[v2].addNeighbor(v1);
 
-    int edgeIndex = size * v1 + v2; //index in edge existence table - for v1->v2
-    int edgeIndexReverse = size * v2 + v1; //for v2->v1
-    edges[edgeIndex] = true;
+    if (dynamic)
+    {
+        repairEdge(v1, v2);
+    }
+}
+
+void AdjacencyList::removeEdge(int v1, int v2)
+{
+    //Removes the edge between vertices v1 and v2
+
+    //Error checking
+    if (v1 < 0 || v2 < 0 || (size_t)v1 >= size || (size_t)v2 >= size)
+        throw std::out_of_range("Invalid vertex input");
+
+    if (frozen)
+        thaw();
+
+    GRAPH_COUNT(stats.edgeProbes, 1);
+    bool removed = directed ? edgeSet->erase(v1, v2) : edgeSet->erase(std::min(v1, v2), std::max(v1, v2));
+    if (!removed)
+        return;
+
+    vertices[v1].removeNeighbor(v2);
     if (!directed)
-        edges[edgeIndexReverse] = true;
+        vertices[v2].removeNeighbor(v1);
+
+    if (dynamic)
+    {
+        //The coloring stays valid, but either endpoint may now fit in a lower color
+        lowerColor(v1);
+        lowerColor(v2);
+    }
+}
+
+void AdjacencyList::freeze(AdjacencyList::EdgeIndex index)
+{
+    //Packs the per-vertex neighbor lists into one offsets array and one contiguous neighbor array
+    //The linked lists are released afterwards. Calling freeze() on a frozen graph does nothing
+    //Rows are sorted so hasEdge can binary search them when the hash index is dropped
+    if (frozen)
+        return;
+
+    offsets = new size_t[size + 1];
+    offsets[0] = 0;
+    for (size_t i = 0; i < size; i++)
+        offsets[i + 1] = offsets[i] + vertices[i].neighbors.size();
+
+    adjacency = new int[offsets[size]];
+    for (size_t i = 0; i < size; i++)
+    {
+        size_t pos = offsets[i];
+        for (auto iter = vertices[i].neighbors.begin(); !iter.isEnd(); iter++)
+            adjacency[pos++] = *iter;
+        vertices[i].neighbors.clear();
+        std::sort(adjacency + offsets[i], adjacency + offsets[i + 1]);
+    }
+    neighborPool->release(); //every list is empty now, hand the blocks back in one go
+
+    frozen = true;
+    buildIndex(index);
+}
+
+void AdjacencyList::hashEdges()
+{
+    //Builds edgeSet from the CSR arrays, undirected edges are inserted once as (v1 <= v2)
+    edgeSet = new PairSet(directed ? offsets[size] : offsets[size] / 2);
+    for (size_t i = 0; i < size; i++)
+        for (size_t j = offsets[i]; j < offsets[i + 1]; j++)
+            if (directed || (int)i <= adjacency[j])
+                edgeSet->insert(i, adjacency[j]);
+}
+
+void AdjacencyList::buildIndex(AdjacencyList::EdgeIndex index)
+{
+    //Sets up the hasEdge index for the frozen CSR arrays
+    //Bit rows once they take at most 1/4 of the memory of the CSR rows,
+    //otherwise sparse rows are cheaper to binary search than to keep hashed
+    if (index == EdgeIndex::AUTO)
+    {
+        if (offsets[size] * 8 >= size * size)
+            index = EdgeIndex::DENSE;
+        else if (offsets[size] > 64 * size)
+            index = EdgeIndex::HASH;
+        else
+            index = EdgeIndex::SORTED;
+    }
+
+    if (index == EdgeIndex::DENSE)
+    {
+        dense = new BitMatrix(size);
+        for (size_t i = 0; i < size; i++)
+            for (size_t j = offsets[i]; j < offsets[i + 1]; j++)
+                dense->set(i, adjacency[j]);
+    }
+
+    if (index == EdgeIndex::HASH && edgeSet == nullptr)
+        hashEdges();
+    else if (index != EdgeIndex::HASH)
+    {
+        delete edgeSet;
+        edgeSet = nullptr;
+    }
+}
+
+void AdjacencyList::buildFromDense()
+{
+    //Lays out the frozen CSR arrays from the bit rows in dense
+    //Row lengths come from popcounts and the neighbors come out already sorted
+    offsets = new size_t[size + 1];
+    offsets[0] = 0;
+    for (size_t i = 0; i < size; i++)
+        offsets[i + 1] = offsets[i] + dense->rowCount(i);
+
+    adjacency = new int[offsets[size]];
+    for (size_t i = 0; i < size; i++)
+    {
+        const uint64_t* row = dense->row(i);
+        size_t pos = offsets[i];
+        for (size_t w = 0; w < dense->words(); w++)
+        {
+            uint64_t bits = row[w];
+            while (bits)
+            {
+                adjacency[pos++] = w * 64 + __builtin_ctzll(bits);
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    frozen = true;
+}
+
+void AdjacencyList::thaw()
+{
+    //Rebuilds the per-vertex neighbor lists from the CSR arrays so edges can be added again
+    if (!frozen)
+        return;
+
+    for (size_t i = 0; i < size; i++)
+        for (size_t j = offsets[i]; j < offsets[i + 1]; j++)
+            vertices[i].addNeighbor(adjacency[j]);
+
+    if (edgeSet == nullptr)
+        hashEdges();
+
+    releaseCsr();
+    delete dense;
+    dense = nullptr;
+    frozen = false;
+}
+
+void AdjacencyList::releaseCsr()
+{
+    //Frees or unmaps the CSR arrays
+    if (mapping != nullptr)
+        munmap(mapping, mappingLength);
+    else
+    {
+        delete[] offsets;
+        delete[] adjacency;
+    }
+
+    mapping = nullptr;
+    mappingLength = 0;
+    offsets = nullptr;
+    adjacency = nullptr;
+}
+
+bool AdjacencyList::isFrozen() const
+{
+    return frozen;
+}
+
+size_t AdjacencyList::degree(int v) const
+{
+    //Number of neighbors of v, from whichever representation is current
+    if (frozen)
+        return offsets[v + 1] - offsets[v];
+    return vertices[v].neighbors.size();
 }
 
 size_t AdjacencyList::V()
@@ -180,11 +872,12 @@ void AdjacencyList::print()
     Mostly for debugging
     */
 
+    freeze();
     for (size_t i = 0; i < size; i++)
     {
         std::cout << vertices[i].id << ",";
-        for (auto iter = vertices[i].neighbors.begin(); !iter.isEnd(); iter++)
-            std::cout << *iter << ",";
+        for (size_t j = offsets[i]; j < offsets[i + 1]; j++)
+            std::cout << adjacency[j] << ",";
 
         std::cout << std::endl;
     }
@@ -193,301 +886,1570 @@ void AdjacencyList::print()
 
 void AdjacencyList::save(std::string filename)
 {
-    std::ofstream f(filename);
-    f << size << std::endl; //num vertices
+    freeze();
+    OutputWriter f(filename, asyncOutput);
+    f << size << '\n'; //num vertices
     
     //Starting lines for each vertex
-    int pos = 1 + size + 1; //keep track of starting pos for each vertex
+    size_t firstLine = 1 + size + 1;
     for (size_t i = 0; i < size; i++)
-    {
-        f << pos << std::endl;
-        pos += vertices[i].neighbors.size();
-    }
+        f << firstLine + offsets[i] << '\n';
 
-    //Edges
-    for (size_t i = 0; i < size; i++)
-        for (auto iter = vertices[i].neighbors.begin(); !iter.isEnd(); iter++)
-            f << *iter << std::endl;
+    //Edges - already laid out in file order by the CSR array
+    for (size_t j = 0; j < offsets[size]; j++)
+        f << adjacency[j] << '\n';
 
     f.close();
 }
 
-void AdjacencyList::genDegreeList()
+static const char* checkBinary(const void* data, size_t length)
 {
-    //Generates the degree list for the current graph
-    //Should be called once the graph has been generated
+    //Checks a mapped binary graph file in one O(V + E) pass before its arrays are used in place
+    //Returns what is wrong with it to append to the file name, or nullptr if it can be used
+    //The sizes are checked against what is left of the file before they are multiplied, so nothing can overflow
+    const BinaryGraphHeader* header = (const BinaryGraphHeader*)data;
+    if (std::memcmp(header->magic, BINARY_MAGIC, 8) != 0 || header->version != BINARY_VERSION || header->idWidth != sizeof(int))
+        return " is not a supported binary graph file";
+
+    uint64_t n = header->numVertices;
+    size_t rest = length - sizeof(BinaryGraphHeader);
+    if (n > (uint64_t)INT_MAX || n + 1 > rest / sizeof(uint64_t))
+        return " is truncated";
+    rest -= (n + 1) * sizeof(uint64_t);
+
+    const uint64_t* offsets = (const uint64_t*)((const char*)data + sizeof(BinaryGraphHeader));
+    const int* adjacency = (const int*)(offsets + n + 1);
+    if (offsets[0] != 0)
+        return " has bad CSR offsets";
+    for (uint64_t i = 0; i < n; i++)
+        if (offsets[i + 1] < offsets[i])
+            return " has bad CSR offsets";
+    if (offsets[n] > rest / sizeof(int))
+        return " is truncated";
+    if (header->numEdges != (header->directed ? offsets[n] : offsets[n] / 2))
+        return " has a wrong edge count";
+
+    //hasEdge binary searches the rows when the header says they are sorted, so that is checked too
+    for (uint64_t i = 0; i < n; i++)
+        for (uint64_t j = offsets[i]; j < offsets[i + 1]; j++)
+        {
+            if (adjacency[j] < 0 || (uint64_t)adjacency[j] >= n)
+                return " has a neighbor id out of range";
+            if (header->sorted && j > offsets[i] && adjacency[j] < adjacency[j - 1])
+                return " has an unsorted row";
+        }
 
-    for (size_t i = 0; i < size; i++)
+    return nullptr;
+}
+
+AdjacencyList AdjacencyList::loadBinary(std::string filename)
+{
+    //Maps a binary graph file and uses its CSR arrays in place, nothing is parsed or copied
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open " + filename);
+
+    struct stat st;
+    fstat(fd, &st);
+    size_t length = st.st_size;
+    if (length < sizeof(BinaryGraphHeader))
     {
-        int degree = vertices[i].neighbors.size();
-        degreeList[degree].push_front(vertices[i].id); //insert to linked list at index "degree"
-        vertices[i].degreePtr = degreeList[degree].begin(); //add reference to element in linked list
-        vertices[i].originalDegree = degree;
-        vertices[i].currentDegree = degree;
-        averageOriginalDegree += degree;
+        close(fd);
+        throw std::runtime_error(filename + " is not a binary graph file");
     }
-    averageOriginalDegree /= size;
+
+    void* data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        throw std::runtime_error("Cannot map " + filename);
+
+    const char* problem = checkBinary(data, length);
+    if (problem != nullptr)
+    {
+        munmap(data, length);
+        throw std::runtime_error(filename + problem);
+    }
+
+    const BinaryGraphHeader* header = (const BinaryGraphHeader*)data;
+    size_t offsetBytes = (header->numVertices + 1) * sizeof(uint64_t);
+    size_t* fileOffsets = (size_t*)((char*)data + sizeof(BinaryGraphHeader));
+    int* fileAdjacency = (int*)((char*)data + sizeof(BinaryGraphHeader) + offsetBytes);
+
+    AdjacencyList adj(header->numVertices, header->directed != 0);
+    GRAPH_PHASE(adj.stats.construction);
+    adj.offsets = fileOffsets;
+    adj.adjacency = fileAdjacency;
+    adj.mapping = data;
+    adj.mappingLength = length;
+    adj.frozen = true;
+
+    delete adj.edgeSet;
+    adj.edgeSet = nullptr;
+    if (!header->sorted) //rows can't be binary searched, index them by hash instead
+        adj.hashEdges();
+
+    return adj;
+}
+
+void AdjacencyList::saveBinary(std::string filename)
+{
+    freeze();
+
+    BinaryGraphHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BINARY_MAGIC, 8);
+    header.version = BINARY_VERSION;
+    header.idWidth = sizeof(int);
+    header.numVertices = size;
+    header.numEdges = E();
+    header.directed = directed;
+    header.sorted = 1; //freeze() sorts every row, but a graph loaded from an unsorted binary file is frozen already
+    for (size_t i = 0; i < size && header.sorted; i++)
+        header.sorted = std::is_sorted(adjacency + offsets[i], adjacency + offsets[i + 1]);
+
+    std::ofstream f(filename, std::ios::binary);
+    f.write((const char*)&header, sizeof(header));
+    f.write((const char*)offsets, (size + 1) * sizeof(size_t));
+    f.write((const char*)adjacency, offsets[size] * sizeof(int));
+    f.close();
+}
+
+void AdjacencyList::convertToBinary(std::string textFile, std::string binaryFile, bool isDirected)
+{
+    AdjacencyList adj(textFile, isDirected);
+    adj.saveBinary(binaryFile);
 }
 
-void AdjacencyList::delVertex(int v)
+void AdjacencyList::convertToText(std::string binaryFile, std::string textFile)
+{
+    AdjacencyList adj = loadBinary(binaryFile);
+    adj.save(textFile);
+}
+
+size_t AdjacencyList::E()
+{
+    //Returns |E|, undirected edges are counted once
+    freeze();
+    return directed ? offsets[size] : offsets[size] / 2;
+}
+
+void AdjacencyList::delVertex(int v, DegreeBuckets& buckets) const
 {
     //Mark a vertex as removed during the coloring process
     //Handles changing the degree of neighboring vertices
 
-    Node& n = vertices[v];
-    n.deleted = true;
-    degreeList[n.currentDegree].erase(n.degreePtr);
+    buckets.remove(v);
 
     //Decrement degree of v's neighbors
-    if (n.neighbors.size() > 0)
+    GRAPH_COUNT(stats.neighborsVisited, offsets[v + 1] - offsets[v]);
+    for (size_t j = offsets[v]; j < offsets[v + 1]; j++)
     {
-        for (auto iter = n.neighbors.begin(); !iter.isEnd(); iter++)
+        int u = adjacency[j];
+        if (buckets.contains(u))
         {
-            Node& neighbor = vertices[*iter];
-            if (!neighbor.deleted)
-            {
-                degreeList[neighbor.currentDegree].erase(neighbor.degreePtr);
-                neighbor.currentDegree--;
-                degreeList[neighbor.currentDegree].push_front(neighbor.id);
-                neighbor.degreePtr = degreeList[neighbor.currentDegree].begin();
-            }
+            buckets.move(u, buckets.bucketOf(u) - 1);
+            GRAPH_COUNT(stats.bucketMoves, 1);
         }
     }
-    
+
 }
 
 void AdjacencyList::outputFile(std::string filename)
 {
-    std::fstream file(filename + ".csv");
-    file << "vertex,color" << std::endl;
+    OutputWriter file(filename + ".csv", asyncOutput);
+    file << "vertex,color\n";
     for (size_t i = 0; i < size; i++)
-        file << i << "," << vertices[i].color << std::endl;
+        file << i << ',' << vertices[i].color << '\n';
 
     file.close();
 }
 
-void AdjacencyList::colorGraph(AdjacencyList::Coloring algorithm)
+AdjacencyList::ColoringResult AdjacencyList::colorGraph(AdjacencyList::Coloring algorithm)
 {
-    if (algorithm == AdjacencyList::Coloring::SLVO)
-        SLVO();
-    else if (algorithm == AdjacencyList::Coloring::SODL)
-        SODL();
-    else if (algorithm == AdjacencyList::Coloring::RANDOM)
-        RANDOM();
-    else if (algorithm == AdjacencyList::Coloring::LLVO)
-        LLVO();
-    else if (algorithm == AdjacencyList::Coloring::LODL)
-        LODL();
-    else
-        inOrder();
+    return colorGraph(algorithm, ownWorkspace());
 }
 
-void AdjacencyList::colorList(int* order, int* degWhenDel)
+AdjacencyList::ColoringResult AdjacencyList::colorGraph(AdjacencyList::Coloring algorithm, ColoringWorkspace& ws)
 {
-    //Colors the graph based on the given vertex ordering
-    int maxColor = 1;
+    freeze();
+    bool hasDegrees = runColoring(algorithm, ws, rng, phaseTimes);
     for (size_t i = 0; i < size; i++)
+        vertices[i].color = ws.colors[i];
+
+    //Collect the result, and output the coloring and summary stats if there is a report sink
+    auto colored = std::chrono::steady_clock::now();
+    ColoringResult result = collectResult(algorithm, ws.order, ws.colors, hasDegrees ? ws.degreeWhenDel : nullptr);
+    if (report != nullptr)
     {
-        Node& v1 = vertices[order[i]];
-        int color = 1;
-        for (size_t j = 0; j < i; j++)
-        {
-            Node& v2 = vertices[order[j]];
-            if (hasEdge(v1.id, v2.id) && color == v2.color)
-                color++;
-        }
-        v1.color = color;
-        if (color > maxColor)
-            maxColor = color;
+        printColoring(result);
+        if (algorithm == AdjacencyList::Coloring::SLVO)
+            slvoSummary(result);
+    }
+    auto printed = std::chrono::steady_clock::now();
+    phaseTimes.output = std::chrono::duration<double>(printed - colored).count();
 
-        //Printing
-        std::cout << "Vertex " << v1.id << ":" << std::endl;
-        std::cout << "Color: " << color << ", Original degree: " << v1.originalDegree;
-        if (degWhenDel == nullptr)
-            std::cout << std::endl;
-        else
-            std::cout << ", Degree when deleted: " << degWhenDel[i] << std::endl;
+    if (dynamic)
+        trackColoring();
+    return result;
+}
 
-        puts("");
+bool AdjacencyList::runColoring(AdjacencyList::Coloring algorithm, ColoringWorkspace& ws, Rng& rng, PhaseTimes& times)
+{
+    //Orders and colors the frozen graph, filling ws.order, ws.colors and for SLVO and LLVO ws.degreeWhenDel
+    //Returns true if degreeWhenDel was filled
+    prepareWorkspace(ws);
+    bool hasDegrees = false;
+
+    auto start = std::chrono::steady_clock::now();
+    auto ordered = start;
+    if (algorithm == AdjacencyList::Coloring::JONES_PLASSMANN)
+        jonesPlassmann(false, ws.order, ws.colors, rng.next());
+    else if (algorithm == AdjacencyList::Coloring::JONES_PLASSMANN_LDF)
+        jonesPlassmann(true, ws.order, ws.colors, rng.next());
+    else if (algorithm == AdjacencyList::Coloring::DSATUR)
+        dsatur(ws); //picks the order as it colors, so its time all counts as coloring
+    else if (algorithm == AdjacencyList::Coloring::RLF)
+        rlf(ws);
+    else
+    {
+        hasDegrees = buildOrder(algorithm, ws, rng);
+        ordered = std::chrono::steady_clock::now();
+        if (!ws.stopped)
+            colorList(ws);
+    }
+    auto colored = std::chrono::steady_clock::now();
+
+    times.ordering = std::chrono::duration<double>(ordered - start).count();
+    times.coloring = std::chrono::duration<double>(colored - ordered).count();
+    if (algorithm == AdjacencyList::Coloring::JONES_PLASSMANN || algorithm == AdjacencyList::Coloring::JONES_PLASSMANN_LDF)
+        GRAPH_COUNT(stats.coloring, times.coloring); //colorList was not used, so its timer did not run
+    return hasDegrees;
+}
+
+void AdjacencyList::prepareWorkspace(ColoringWorkspace& ws) const
+{
+    //Sizes ws for this graph and queues every vertex in the bucket of its degree, in id order
+    size_t maxDegree = 0;
+    for (size_t i = 0; i < size; i++)
+        maxDegree = std::max(maxDegree, degree(i));
+
+    ws.reserve(size, maxDegree + 1);
+    ws.stopped = false;
+    for (size_t i = 0; i < size; i++)
+        ws.buckets->insert(i, degree(i));
+}
+
+ColoringWorkspace& AdjacencyList::ownWorkspace()
+{
+    if (workspace == nullptr)
+        workspace = new ColoringWorkspace();
+    return *workspace;
+}
+
+AdjacencyList::ColoringResult AdjacencyList::collectResult(AdjacencyList::Coloring algorithm, const int* order, const int* colors, const int* degWhenDel) const
+{
+    //Copies the coloring out of the workspace along with the ordering stats
+    ColoringResult result;
+    result.colors.assign(colors, colors + size);
+    result.order.assign(order, order + size);
+    for (size_t i = 0; i < size; i++)
+        result.numColors = std::max(result.numColors, colors[i]);
+
+    if (degWhenDel != nullptr)
+    {
+        result.degreeWhenDeleted.assign(degWhenDel, degWhenDel + size);
+        for (size_t i = 0; i < size; i++)
+            result.maxDegreeWhenDeleted = std::max(result.maxDegreeWhenDeleted, degWhenDel[i]);
+    }
+
+    if (algorithm == AdjacencyList::Coloring::SLVO)
+        result.terminalCliqueSize = terminalClique(degWhenDel, size);
+
+    return result;
+}
+
+int AdjacencyList::terminalClique(const int* degWhenDel, size_t size)
+{
+    //The terminal clique is the run of strictly increasing degrees when deleted at the end of the SLVO ordering
+    //order[i] was deleted with only i other vertices left, so the run is 0, 1, 2, ... and those vertices are a clique
+    if (size == 0)
+        return 0;
+
+    int clique = 1;
+    for (size_t i = 0; i + 1 < size; i++)
+    {
+        if (!(degWhenDel[i] < degWhenDel[i + 1]))
+            break;
+        clique++;
+    }
+    return clique;
+}
+
+int AdjacencyList::numColors() const
+{
+    int maxColor = 0;
+    for (size_t i = 0; i < size; i++)
+        maxColor = std::max(maxColor, vertices[i].color);
+    return maxColor;
+}
+
+const AdjacencyList::PhaseTimes& AdjacencyList::lastPhaseTimes() const
+{
+    return phaseTimes;
+}
+
+GraphStats AdjacencyList::getStats() const
+{
+    GraphStats result = stats;
+    if (neighborPool != nullptr)
+    {
+        result.nodesAllocated = neighborPool->allocated();
+        result.nodesFreed = neighborPool->freed();
+    }
+    return result;
+}
+
+void AdjacencyList::resetStats()
+{
+    stats = GraphStats();
+    if (neighborPool != nullptr)
+        neighborPool->resetCounters();
+}
+
+void AdjacencyList::saveStats(std::string filename) const
+{
+    std::ofstream file(filename);
+    if (!file)
+        throw std::runtime_error("Cannot open " + filename);
+    file << getStats().toJson();
+}
+
+void AdjacencyList::setReport(std::ostream* sink)
+{
+    //Colorings are silent by default, batch runs read the returned ColoringResult instead
+    report = sink;
+}
+
+void AdjacencyList::setAsyncOutput(bool async)
+{
+    //Lets the next coloring overlap with writing the results of the previous one
+    asyncOutput = async;
+}
+
+void AdjacencyList::setSeed(uint64_t seed)
+{
+    //Makes the RANDOM ordering and the Jones-Plassmann priorities reproducible
+    rng.seed(seed);
+}
+
+void AdjacencyList::setNumThreads(size_t n)
+{
+    //Sets the number of threads used by the parallel algorithms, 0 uses every hardware thread
+    numThreads = n;
+    delete threadPool;
+    threadPool = nullptr;
+}
+
+ThreadPool& AdjacencyList::pool()
+{
+    if (threadPool == nullptr)
+        threadPool = new ThreadPool(numThreads);
+    return *threadPool;
+}
+
+void AdjacencyList::colorList(ColoringWorkspace& ws) const
+{
+    //Colors the graph based on the vertex ordering in ws.order, ws.colors[v] is the color of vertex v
+    //Each vertex takes the smallest color not used by an already colored neighbor
+    GRAPH_PHASE(stats.coloring);
+    const int* order = ws.order;
+    int* colors = ws.colors;
+    int* forbidden = ws.forbidden;
+    int* denseColors = nullptr;
+    if (dense != nullptr)
+    {
+        denseColors = new int[size];
+        colorDense(order, denseColors);
+    }
+
+    //forbidden[c] == i means color c is taken by a neighbor of order[i], so it never needs clearing
+    //A vertex with d neighbors always finds a free color in 1 ... d + 1
+    std::fill(forbidden, forbidden + size + 2, -1);
+    std::fill(colors, colors + size, -1);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        if (i % ColoringWorkspace::STOP_CHECK == 0 && ws.checkStop())
+            break;
+
+        int v = order[i];
+        int color = 1;
+        if (denseColors != nullptr)
+            color = denseColors[i];
+        else
+        {
+            GRAPH_COUNT(stats.neighborsVisited, offsets[v + 1] - offsets[v]);
+            for (size_t j = offsets[v]; j < offsets[v + 1]; j++)
+            {
+                int c = colors[adjacency[j]];
+                if (c > 0)
+                    forbidden[c] = i;
+            }
+            while (forbidden[color] == (int)i)
+                color++;
+        }
+        colors[v] = color;
+    }
+
+    delete[] denseColors;
+}
+
+void AdjacencyList::printColoring(const ColoringResult& result)
+{
+    //Prints the color of each vertex in the given order followed by a summary
+    //Formatted into large blocks that are handed to the sink whole, the sink is flushed once at the end
+    OutputWriter out(*report);
+    bool hasDegrees = !result.degreeWhenDeleted.empty();
+    size_t totalDegree = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        Node& v1 = vertices[result.order[i]];
+        size_t originalDegree = degree(v1.id); //coloring leaves the graph as it is
+        totalDegree += originalDegree;
+        out << "Vertex " << v1.id << ":\n";
+        out << "Color: " << v1.color << ", Original degree: " << originalDegree;
+        if (hasDegrees)
+            out << ", Degree when deleted: " << result.degreeWhenDeleted[i];
+        out << "\n\n";
+    }
+
+    out << "SUMMARY:\n";
+    out << "Colors used: " << result.numColors << "\n";
+    out << "Average original degree: " << (size > 0 ? (double)totalDegree / size : 0.0) << '\n';
+    out.close();
+}
+
+void AdjacencyList::dsatur(ColoringWorkspace& ws) const
+{
+    //DSatur (Brelaz) colors the uncolored vertex with the most distinct colors among its neighbors (its saturation) next,
+    //ties going to the one with the most uncolored neighbors, and gives it the smallest color they leave free
+    //The heap key packs saturation in the high 32 bits and uncolored degree in the low 32 bits. A PairSet of
+    //(vertex, color) pairs tells whether a neighbor's new color raises the saturation, so a neighbor update is one
+    //hash probe and one O(log V) sift, O((V + E) log V) over the whole run
+    GRAPH_PHASE(stats.coloring);
+    int* colors = ws.colors;
+    int* forbidden = ws.forbidden;
+    std::fill(forbidden, forbidden + size + 2, -1);
+    std::fill(colors, colors + size, -1);
+
+    IndexedHeap queue(size);
+    PairSet seen(size);
+    for (size_t v = 0; v < size; v++)
+        queue.push(v, degree(v));
+
+    const uint64_t SATURATION = 1ULL << 32;
+    for (size_t i = 0; i < size; i++)
+    {
+        if (i % ColoringWorkspace::STOP_CHECK == 0 && ws.checkStop())
+            break;
 
+        int v = queue.pop();
+        GRAPH_COUNT(stats.neighborsVisited, offsets[v + 1] - offsets[v]);
+        for (size_t j = offsets[v]; j < offsets[v + 1]; j++)
+        {
+            int c = colors[adjacency[j]];
+            if (c > 0)
+                forbidden[c] = i;
+        }
+        int color = 1;
+        while (forbidden[color] == (int)i)
+            color++;
+        colors[v] = color;
+        ws.order[i] = v;
+
+        for (size_t j = offsets[v]; j < offsets[v + 1]; j++)
+        {
+            int u = adjacency[j];
+            if (!queue.contains(u))
+                continue;
+            uint64_t key = queue.keyOf(u);
+            if ((key & (SATURATION - 1)) > 0)
+                key--; //one uncolored neighbor less
+            if (seen.insert(u, color))
+                key += SATURATION;
+            queue.update(u, key);
+        }
+    }
+}
+
+void AdjacencyList::rlf(ColoringWorkspace& ws) const
+{
+    //Recursive largest first (Leighton) builds one maximal independent set per color out of the uncolored vertices
+    //It starts from the vertex with the most uncolored neighbors, and then keeps adding the candidate with the most
+    //neighbors among the excluded vertices (those next to the class so far). Ties go to whichever the buckets hold first
+    //Uncolored and candidate vertices are bitsets. With bit rows the candidate neighbors of a vertex are found a word
+    //at a time, otherwise by testing the CSR row against the candidate bits. Excluded counts live in ws.buckets and
+    //only go up within a class, so picking the next vertex is O(1) amortized and each class costs O(V + E)
+    GRAPH_PHASE(stats.coloring);
+    size_t words = BitMatrix::wordsFor(size);
+    uint64_t* uncolored = BitMatrix::allocRow(words);
+    uint64_t* candidates = BitMatrix::allocRow(words);
+    int* uncoloredDegree = new int[size];
+    for (size_t v = 0; v < size; v++)
+    {
+        uncolored[v / 64] |= 1ULL << (v % 64);
+        uncoloredDegree[v] = degree(v);
     }
 
-    std::cout << "SUMMARY:" << std::endl;
-    std::cout << "Colors used: " << maxColor << std::endl;
-    std::cout << "Average original degree: " << averageOriginalDegree << std::endl;
+    //Calls fn(u) for every neighbor u of v in set
+    auto forNeighborsIn = [&](int v, const uint64_t* set, auto fn) {
+        if (dense != nullptr)
+        {
+            const uint64_t* row = dense->row(v);
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t bits = row[w] & set[w];
+                while (bits)
+                {
+                    fn((int)(w * 64 + __builtin_ctzll(bits)));
+                    bits &= bits - 1;
+                }
+            }
+        }
+        else
+        {
+            GRAPH_COUNT(stats.neighborsVisited, offsets[v + 1] - offsets[v]);
+            for (size_t j = offsets[v]; j < offsets[v + 1]; j++)
+            {
+                int u = adjacency[j];
+                if (set[u / 64] >> (u % 64) & 1)
+                    fn(u);
+            }
+        }
+    };
+    auto clearBit = [](uint64_t* set, int v) {
+        set[v / 64] &= ~(1ULL << (v % 64));
+    };
+
+    DegreeBuckets& excluded = *ws.buckets; //bucket = neighbors among the excluded vertices, candidates only
+    std::vector<int> newlyExcluded;
+    size_t colored = 0;
+    for (int color = 1; colored < size && !ws.checkStop(); color++)
+    {
+        //Every uncolored vertex starts as a candidate, and the class starts from the one with the most uncolored neighbors
+        std::copy(uncolored, uncolored + words, candidates);
+        excluded.clear();
+        int v = -1;
+        for (size_t w = 0; w < words; w++)
+        {
+            for (uint64_t bits = uncolored[w]; bits; bits &= bits - 1)
+            {
+                int u = w * 64 + __builtin_ctzll(bits);
+                excluded.insert(u, 0);
+                if (v == -1 || uncoloredDegree[u] > uncoloredDegree[v])
+                    v = u;
+            }
+        }
+
+        size_t classBegin = colored;
+        int top = 0; //no candidate has a higher bucket
+        while (v != -1)
+        {
+            ws.colors[v] = color;
+            ws.order[colored++] = v;
+            clearBit(candidates, v);
+            clearBit(uncolored, v);
+            excluded.remove(v);
+
+            //v's candidate neighbors become excluded, and the candidates next to them move up a bucket
+            newlyExcluded.clear();
+            forNeighborsIn(v, candidates, [&](int x) {
+                clearBit(candidates, x);
+                excluded.remove(x);
+                newlyExcluded.push_back(x);
+            });
+            for (int x : newlyExcluded)
+            {
+                forNeighborsIn(x, candidates, [&](int u) {
+                    int bucket = excluded.bucketOf(u) + 1;
+                    excluded.move(u, bucket);
+                    top = std::max(top, bucket);
+                });
+            }
+
+            v = -1;
+            while (top >= 0 && (v = excluded.first(top)) == -1)
+                top--;
+        }
+
+        //The class leaves the uncolored subgraph
+        for (size_t i = classBegin; i < colored; i++)
+            forNeighborsIn(ws.order[i], uncolored, [&](int u) {
+                uncoloredDegree[u]--;
+            });
+    }
+
+    BitMatrix::freeRow(uncolored);
+    BitMatrix::freeRow(candidates);
+    delete[] uncoloredDegree;
+}
+
+void AdjacencyList::colorDense(const int* order, int* colors) const
+{
+    //First fit coloring on the bit rows. Each color keeps a membership bitset, and a vertex takes
+    //the first color whose members do not intersect its row. colors[i] is the color of order[i]
+    //Each color also tracks the word range its members fall in, so the AND only covers that range
+    size_t words = dense->words();
+    uint64_t** members = new uint64_t*[size];
+    size_t* lo = new size_t[size];
+    size_t* hi = new size_t[size];
+    int numColors = 0;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        int v = order[i];
+        const uint64_t* row = dense->row(v);
+        int c = 0;
+        while (c < numColors && BitMatrix::intersects(row, members[c], lo[c], hi[c] + 1))
+            c++;
+
+        if (c == numColors)
+        {
+            members[c] = BitMatrix::allocRow(words);
+            lo[c] = words;
+            hi[c] = 0;
+            numColors++;
+        }
+
+        size_t w = v / 64;
+        members[c][w] |= 1ULL << (v % 64);
+        lo[c] = std::min(lo[c], w);
+        hi[c] = std::max(hi[c], w);
+        colors[i] = c + 1;
+    }
+
+    for (int c = 0; c < numColors; c++)
+        BitMatrix::freeRow(members[c]);
+    delete[] members;
+    delete[] lo;
+    delete[] hi;
 }
 
-void AdjacencyList::SLVO()
+void AdjacencyList::SLVO(ColoringWorkspace& ws) const
 {
     //Smallest last vertex ordering
+    //degreeWhenDel[i] = degree of deletionOrder[i] when deleted
+    DegreeBuckets& buckets = *ws.buckets;
+    int* deletionOrder = ws.order;
+    int* degreeWhenDel = ws.degreeWhenDel;
 
-    int* deletionOrder = new int[size];
-    int* degreeWhenDel = new int[size]; //[i] = degree of vi when deleted
     int index = size - 1; //current index in deletionOrder
     int deleted = 0; //total number of vertices removed
-    int degreeIndex = 0; //current index in degreeList
-    int maxColors = 1; //keep track of max number of colors needed
+    int degreeIndex = 0; //current bucket
     
     while (deleted < size)
     {
-        LinkedList<int>& degreeI = degreeList[degreeIndex];
-        if (degreeI.size() > 0) //continue if there is no vertex to delete
+        int v = buckets.first(degreeIndex);
+        GRAPH_COUNT(stats.bucketsScanned, 1);
+        if (v != -1) //continue if there is no vertex to delete
         {
-            int v = *(degreeI.begin());
-            delVertex(v);
+            if (deleted % ColoringWorkspace::STOP_CHECK == 0 && ws.checkStop())
+                return;
+            delVertex(v, buckets);
             deletionOrder[index] = v;
             degreeWhenDel[index] = degreeIndex;
-
-            if (degreeIndex + 1 > maxColors)
-                maxColors = degreeIndex + 1;
             
             index--;
             deleted++;
-            degreeIndex = 0; //reset back to degree 0 to get to vertices that lowered in degree
+
+            //Deleting v lowers each neighbor by one, so the smallest degree is now at least degreeIndex - 1
+            if (degreeIndex > 0)
+                degreeIndex--;
         }
         else
             degreeIndex++;
     }
+}
 
-    //Color the graph and output summary stats
-    colorList(deletionOrder, degreeWhenDel);
-    std::cout << "Maximum degree when deleted: " << maxColors << std::endl;
-
-    int termCliqueSize = 1;
-    for (int i = 0; i < size; i++)
-    {
-        if (!(degreeWhenDel[i] < degreeWhenDel[i+1]))
-            break;
-        termCliqueSize++;
-    }
-
-    std::cout << "Size of terminal clique: " << termCliqueSize << std::endl;
-
-    std::ofstream file("slvo_plot.csv");
-    for (int i = 0; i < size; i++)
-        file << i + 1 << "," << degreeWhenDel[i] << std::endl;
+void AdjacencyList::slvoSummary(const ColoringResult& result)
+{
+    //Output the SLVO summary stats and the degree when deleted plot
+    //SLVO never needs more than the maximum degree when deleted + 1 colors
+    *report << "Maximum degree when deleted: " << result.maxDegreeWhenDeleted << "\n";
+    *report << "Size of terminal clique: " << result.terminalCliqueSize << std::endl;
 
-    delete[] deletionOrder;
-    delete[] degreeWhenDel;
+    OutputWriter file("slvo_plot.csv", asyncOutput);
+    for (size_t i = 0; i < size; i++)
+        file << i + 1 << ',' << result.degreeWhenDeleted[i] << '\n';
+    file.close();
 }
 
-void AdjacencyList::SODL()
+void AdjacencyList::SODL(const DegreeBuckets& buckets, int* order) const
 {
     //Smallest original degree last ordering
-    int* order = new int[size];
     int index = size - 1; //current index in Order
-    int degreeIndex = 0; //current index in degreeList
 
-    for (int i = 0; i < size; i++)
+    for (size_t i = 0; i < buckets.buckets(); i++)
     {
-        LinkedList<int>& degreeI = degreeList[i];
-        for (auto iter = degreeI.begin(); !iter.isEnd(); iter++)
+        for (int v = buckets.first(i); v != -1; v = buckets.nextIn(v))
         {
-            order[index] = *iter;
+            order[index] = v;
             index--;
         }
     }
-
-    colorList(order);
-
-    delete[] order;
-
 }
 
-void AdjacencyList::RANDOM()
+void AdjacencyList::RANDOM(int* order, Rng& rng) const
 {
     //Random ordering
-    int* order = new int[size];
     for (int i = 0; i < size; i++)
         order[i] = i;
 
     //Shuffle the sequence -- fisher yates shuffle https://en.wikipedia.org/wiki/Fisher%E2%80%93Yates_shuffle
     for (int i = size - 1; i >= 0; i--)
     {
-        RandomGen rg(i);
-        int j = rg.randUniform();
+        int j = rng.bounded(i + 1);
         std::swap(order[j], order[i]);
     }
-    
-    colorList(order);
-
-    delete[] order;
-    
 }
 
-void AdjacencyList::LLVO()
+void AdjacencyList::LLVO(ColoringWorkspace& ws) const
 {
     //Largest last vertex ordering
+    //degreeWhenDel[i] = degree of deletionOrder[i] when deleted
+    DegreeBuckets& buckets = *ws.buckets;
+    int* deletionOrder = ws.order;
+    int* degreeWhenDel = ws.degreeWhenDel;
 
-    int* deletionOrder = new int[size];
-    int* degreeWhenDel = new int[size]; //[i] = degree of vi when deleted
     int index = size - 1; //current index in deletionOrder
     int deleted = 0; //total number of vertices removed
-    int degreeIndex = size - 1; //current index in degreeList, start at highest degree for LLVO
+    int degreeIndex = buckets.buckets() - 1; //current bucket, start at highest degree for LLVO
     
     while (deleted < size)
     {
-        LinkedList<int>& degreeI = degreeList[degreeIndex];
-        if (degreeI.size() > 0) //continue if there is no vertex to delete
+        int v = buckets.first(degreeIndex);
+        GRAPH_COUNT(stats.bucketsScanned, 1);
+        if (v != -1) //continue if there is no vertex to delete
         {
-            int v = *(degreeI.begin());
-            delVertex(v);
+            if (deleted % ColoringWorkspace::STOP_CHECK == 0 && ws.checkStop())
+                return;
+            delVertex(v, buckets);
             deletionOrder[index] = v;
             degreeWhenDel[index] = degreeIndex;
             
             index--;
             deleted++;
-            degreeIndex = size - 1; //reset back to degree 0 to get to vertices that lowered in degree
+            //Degrees only go down, so the largest degree never climbs back above degreeIndex
         }
         else
             degreeIndex--;
     }
-
-    colorList(deletionOrder, degreeWhenDel);
-
-    delete[] deletionOrder;
-    delete[] degreeWhenDel;
 }
 
-void AdjacencyList::LODL()
+void AdjacencyList::LODL(const DegreeBuckets& buckets, int* order) const
 {
     //Largest original degree last ordering
-    int* order = new int[size];
     int index = 0; //current index in Order
-    int degreeIndex = 0; //current index in degreeList
 
-    for (int i = 0; i < size; i++)
+    for (size_t i = 0; i < buckets.buckets(); i++)
     {
-        LinkedList<int>& degreeI = degreeList[i];
-        for (auto iter = degreeI.begin(); !iter.isEnd(); iter++)
+        for (int v = buckets.first(i); v != -1; v = buckets.nextIn(v))
         {
-            order[index] = *iter;
+            order[index] = v;
             index++;
         }
     }
+}
+
+void AdjacencyList::inOrder(int* order) const
+{
+    for (int i = 0; i < size; i++)
+        order[i] = i;
+}
+
+bool AdjacencyList::buildOrder(AdjacencyList::Coloring algorithm, ColoringWorkspace& ws, Rng& rng) const
+{
+    //Fills ws.order with the vertex ordering of the given algorithm, ws must have been prepared
+    //Returns true if the ordering also filled ws.degreeWhenDel
+    GRAPH_PHASE(stats.ordering);
+    if (algorithm == AdjacencyList::Coloring::SLVO)
+        SLVO(ws);
+    else if (algorithm == AdjacencyList::Coloring::SODL)
+        SODL(*ws.buckets, ws.order);
+    else if (algorithm == AdjacencyList::Coloring::RANDOM)
+        RANDOM(ws.order, rng);
+    else if (algorithm == AdjacencyList::Coloring::LLVO)
+        LLVO(ws);
+    else if (algorithm == AdjacencyList::Coloring::LODL)
+        LODL(*ws.buckets, ws.order);
+    else if (algorithm == AdjacencyList::Coloring::IN_ORDER)
+        inOrder(ws.order);
+    else
+        throw std::invalid_argument("Coloring algorithm has no vertex ordering");
+
+    return algorithm == AdjacencyList::Coloring::SLVO || algorithm == AdjacencyList::Coloring::LLVO;
+}
+
+static uint64_t mix64(uint64_t x)
+{
+    //splitmix64 finalizer, used to derive per-vertex random priorities from a seed
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+void AdjacencyList::jonesPlassmann(bool largestDegreeFirst, int* order, int* colors, uint64_t seed)
+{
+    //Parallel Jones-Plassmann coloring
+    //Every vertex gets a random priority (degree first for the LDF variant) and is colored once all of its
+    //higher priority neighbors are. The vertices that become ready in the same round are an independent set,
+    //so each round colors all of them in parallel without any conflicts
+    //order is filled with the vertices in the order they were colored, one round after another
+    //A vertex waits on the higher priority vertices in its own row, which only signal it if the rows are symmetric
+    if (directed)
+        throw std::logic_error("Jones-Plassmann coloring needs an undirected graph");
+
+    ThreadPool& threads = pool();
+    size_t numWorkers = threads.size();
+
+    uint64_t* priority = new uint64_t[size];
+    std::atomic<int>* waiting = new std::atomic<int>[size]; //uncolored neighbors with a higher priority
+    size_t maxDegree = 0;
+    for (size_t i = 0; i < size; i++)
+        maxDegree = std::max(maxDegree, degree(i));
+
+    threads.parallelFor(size, 4096, [&](size_t begin, size_t end, size_t) {
+        for (size_t v = begin; v < end; v++)
+        {
+            uint64_t r = mix64(seed ^ v) & 0xffffffffULL;
+            priority[v] = largestDegreeFirst ? ((uint64_t)degree(v) << 32) | r : r;
+            colors[v] = -1;
+        }
+    });
+
+    auto higher = [&](int u, int v) {
+        return priority[u] > priority[v] || (priority[u] == priority[v] && u > v);
+    };
+
+    //Each worker collects the vertices it makes ready, the lists are appended to order after every step
+    std::vector<std::vector<int>> ready(numWorkers);
+    size_t roundEnd = 0;
+    auto appendReady = [&]() {
+        for (auto& list : ready)
+        {
+            for (int v : list)
+                order[roundEnd++] = v;
+            list.clear();
+        }
+    };
+
+    threads.parallelFor(size, 4096, [&](size_t begin, size_t end, size_t worker) {
+        for (size_t v = begin; v < end; v++)
+        {
+            int count = 0;
+            for (size_t j = offsets[v]; j < offsets[v + 1]; j++)
+                if (higher(adjacency[j], v))
+                    count++;
+            waiting[v].store(count, std::memory_order_relaxed);
+            if (count == 0)
+                ready[worker].push_back(v);
+        }
+    });
+    appendReady();
+
+    //forbidden[w][c] == v means color c is taken by a neighbor of v, stamped so it never needs clearing
+    int** forbidden = new int*[numWorkers];
+    for (size_t w = 0; w < numWorkers; w++)
+    {
+        forbidden[w] = new int[maxDegree + 2];
+        for (size_t c = 0; c < maxDegree + 2; c++)
+            forbidden[w][c] = -1;
+    }
+
+    size_t roundBegin = 0;
+    while (roundBegin < roundEnd)
+    {
+        size_t begin = roundBegin, count = roundEnd - roundBegin;
+
+        //Color the round, only higher priority neighbors have a color and they were colored in earlier rounds
+        threads.parallelFor(count, 256, [&](size_t first, size_t last, size_t worker) {
+            int* f = forbidden[worker];
+            for (size_t i = begin + first; i < begin + last; i++)
+            {
+                int v = order[i];
+                for (size_t j = offsets[v]; j < offsets[v + 1]; j++)
+                {
+                    int c = colors[adjacency[j]];
+                    if (c > 0)
+                        f[c] = v;
+                }
+                int color = 1;
+                while (f[color] == v)
+                    color++;
+                colors[v] = color;
+            }
+        });
 
-    colorList(order);
+        //Release lower priority neighbors, the last one to release a vertex queues it for the next round
+        threads.parallelFor(count, 256, [&](size_t first, size_t last, size_t worker) {
+            for (size_t i = begin + first; i < begin + last; i++)
+            {
+                int v = order[i];
+                for (size_t j = offsets[v]; j < offsets[v + 1]; j++)
+                {
+                    int u = adjacency[j];
+                    if (higher(v, u) && waiting[u].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        ready[worker].push_back(u);
+                }
+            }
+        });
 
-    delete[] order;
+        roundBegin = roundEnd;
+        appendReady();
+    }
 
+    for (size_t w = 0; w < numWorkers; w++)
+        delete[] forbidden[w];
+    delete[] forbidden;
+    delete[] priority;
+    delete[] waiting;
 }
 
-void AdjacencyList::inOrder()
+AdjacencyList::ColoringResult AdjacencyList::colorGraphSpeculative(AdjacencyList::Coloring ordering)
 {
-    int* order = new int[size];
-    for (int i = 0; i < size; i++)
-        order[i] = i;
+    //Optimistic parallel greedy coloring (Gebremedhin-Manne)
+    //Threads first-fit color chunks of the ordering at the same time without locking, reading whatever colors
+    //their neighbors have so far. A detection pass then finds neighbors that ended up with the same color and
+    //the one later in the ordering is recolored in the next round, until no conflicts are left
+    freeze();
+    int rounds = 0;
+    size_t conflicts = 0;
+    ThreadPool& threads = pool();
+    size_t numWorkers = threads.size();
+
+    ColoringWorkspace& ws = ownWorkspace();
+    prepareWorkspace(ws);
+    int* order = ws.order;
+    auto start = std::chrono::steady_clock::now();
+    bool hasDegrees = buildOrder(ordering, ws, rng);
+    auto ordered = std::chrono::steady_clock::now();
+
+    int* position = new int[size]; //index of each vertex in order, the earlier vertex keeps its color
+    std::atomic<int>* colors = new std::atomic<int>[size];
+    for (size_t i = 0; i < size; i++)
+    {
+        position[order[i]] = i;
+        colors[i].store(0, std::memory_order_relaxed);
+    }
+
+    size_t maxDegree = 0;
+    for (size_t i = 0; i < size; i++)
+        maxDegree = std::max(maxDegree, degree(i));
+
+    //forbidden[w][c] == v means color c is taken by a neighbor of v, stamped so it never needs clearing
+    int** forbidden = new int*[numWorkers];
+    for (size_t w = 0; w < numWorkers; w++)
+    {
+        forbidden[w] = new int[maxDegree + 2];
+        for (size_t c = 0; c < maxDegree + 2; c++)
+            forbidden[w][c] = -1;
+    }
+
+    //Vertices still to color, kept in ordering order so every chunk is a contiguous piece of the ordering
+    int* work = new int[size];
+    bool* conflicted = new bool[size];
+    std::copy(order, order + size, work);
+    size_t workSize = size;
+
+    while (workSize > 0)
+    {
+        rounds++;
+
+        threads.parallelFor(workSize, 1024, [&](size_t first, size_t last, size_t worker) {
+            int* f = forbidden[worker];
+            for (size_t i = first; i < last; i++)
+            {
+                int v = work[i];
+                for (size_t j = offsets[v]; j < offsets[v + 1]; j++)
+                {
+                    int c = colors[adjacency[j]].load(std::memory_order_relaxed);
+                    if (c > 0)
+                        f[c] = v;
+                }
+                int color = 1;
+                while (f[color] == v)
+                    color++;
+                colors[v].store(color, std::memory_order_relaxed);
+            }
+        });
+
+        //Only vertices colored this round can conflict, and only with each other
+        threads.parallelFor(workSize, 1024, [&](size_t first, size_t last, size_t) {
+            for (size_t i = first; i < last; i++)
+            {
+                int v = work[i];
+                int c = colors[v].load(std::memory_order_relaxed);
+                conflicted[i] = false;
+                for (size_t j = offsets[v]; j < offsets[v + 1]; j++)
+                {
+                    int u = adjacency[j];
+                    if (colors[u].load(std::memory_order_relaxed) == c && position[u] < position[v])
+                    {
+                        conflicted[i] = true;
+                        break;
+                    }
+                }
+            }
+        });
+
+        size_t next = 0;
+        for (size_t i = 0; i < workSize; i++)
+            if (conflicted[i])
+                work[next++] = work[i];
+        workSize = next;
+        conflicts += next;
+    }
+
+    for (size_t i = 0; i < size; i++)
+    {
+        ws.colors[i] = colors[i].load(std::memory_order_relaxed);
+        vertices[i].color = ws.colors[i];
+    }
+    auto colored = std::chrono::steady_clock::now();
+
+    ColoringResult result = collectResult(ordering, order, ws.colors, hasDegrees ? ws.degreeWhenDel : nullptr);
+    result.rounds = rounds;
+    result.conflicts = conflicts;
+    if (report != nullptr)
+        printColoring(result);
+    auto printed = std::chrono::steady_clock::now();
+
+    phaseTimes.ordering = std::chrono::duration<double>(ordered - start).count();
+    phaseTimes.coloring = std::chrono::duration<double>(colored - ordered).count();
+    phaseTimes.output = std::chrono::duration<double>(printed - colored).count();
+    GRAPH_COUNT(stats.coloring, phaseTimes.coloring);
+
+    for (size_t w = 0; w < numWorkers; w++)
+        delete[] forbidden[w];
+    delete[] forbidden;
+    delete[] position;
+    delete[] colors;
+    delete[] work;
+    delete[] conflicted;
+    if (dynamic)
+        trackColoring();
+
+    return result;
+}
+
+AdjacencyList::PortfolioResult AdjacencyList::colorPortfolio(const std::vector<AdjacencyList::Coloring>& algorithms, size_t randomRestarts, double deadlineSeconds, int lowerBound)
+{
+    //The graph is frozen up front, after that the runs only read it
+    freeze();
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<AdjacencyList::Coloring> runs(algorithms);
+    runs.insert(runs.end(), randomRestarts, AdjacencyList::Coloring::RANDOM);
+    for (AdjacencyList::Coloring algorithm : runs)
+        if (algorithm == AdjacencyList::Coloring::JONES_PLASSMANN || algorithm == AdjacencyList::Coloring::JONES_PLASSMANN_LDF)
+            throw std::invalid_argument("Jones-Plassmann cannot run in a portfolio");
+
+    //Every run gets its own stream, split off in run order so a fixed seed gives the same runs
+    std::vector<Rng> streams;
+    for (size_t i = 0; i < runs.size(); i++)
+        streams.push_back(rng.split());
+
+    //One edge means at least 2 colors, and any vertex at least 1
+    PortfolioResult portfolio;
+    portfolio.lowerBound = std::max(lowerBound, size == 0 ? 0 : E() > 0 ? 2 : 1);
+
+    ThreadPool& threads = pool();
+    ColoringWorkspace* workspaces = new ColoringWorkspace[threads.size()];
+    std::atomic<bool> cancel(false);
+    std::atomic<size_t> nextRun(0);
+    std::mutex mtx; //guards portfolio
+    auto deadline = deadlineSeconds > 0 ? start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(deadlineSeconds)) : std::chrono::steady_clock::time_point::max();
+
+    threads.run([&](size_t worker) {
+        GraphStats::suspended = true;
+        ColoringWorkspace& ws = workspaces[worker];
+        ws.cancel = &cancel;
+        ws.deadline = deadline;
+        while (true)
+        {
+            size_t run = nextRun.fetch_add(1);
+            if (run >= runs.size())
+                break;
+
+            PhaseTimes times;
+            bool hasDegrees = false;
+            if (!ws.checkStop())
+                hasDegrees = runColoring(runs[run], ws, streams[run], times);
+            if (ws.stopped)
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                portfolio.runsCancelled++;
+                continue;
+            }
+
+            int numColors = size == 0 ? 0 : *std::max_element(ws.colors, ws.colors + size);
+            int clique = runs[run] == AdjacencyList::Coloring::SLVO ? terminalClique(ws.degreeWhenDel, size) : 0;
+            std::lock_guard<std::mutex> lock(mtx);
+            portfolio.runsFinished++;
+            if (portfolio.runsFinished == 1 || numColors < portfolio.best.numColors)
+            {
+                portfolio.best = collectResult(runs[run], ws.order, ws.colors, hasDegrees ? ws.degreeWhenDel : nullptr);
+                portfolio.algorithm = runs[run];
+            }
+            portfolio.lowerBound = std::max(portfolio.lowerBound, clique);
+            if (portfolio.best.numColors <= portfolio.lowerBound)
+                cancel.store(true, std::memory_order_relaxed); //nothing can beat it
+        }
+        GraphStats::suspended = false;
+    });
+    delete[] workspaces;
+
+    auto colored = std::chrono::steady_clock::now();
+    if (portfolio.runsFinished > 0)
+    {
+        for (size_t i = 0; i < size; i++)
+            vertices[i].color = portfolio.best.colors[i];
+        if (report != nullptr)
+        {
+            printColoring(portfolio.best);
+            if (portfolio.algorithm == AdjacencyList::Coloring::SLVO)
+                slvoSummary(portfolio.best);
+        }
+        if (dynamic)
+            trackColoring();
+    }
+    auto printed = std::chrono::steady_clock::now();
+
+    //The runs overlap, so only the wall clock time of the whole portfolio is reported
+    phaseTimes.ordering = 0;
+    phaseTimes.coloring = std::chrono::duration<double>(colored - start).count();
+    phaseTimes.output = std::chrono::duration<double>(printed - colored).count();
+    return portfolio;
+}
+
+AdjacencyList::ColoringResult AdjacencyList::improveColoring(double seconds, size_t iterations, bool useTabu)
+{
+    //Works on the colors the graph holds, and hands the best coloring found back to it
+    if (seconds <= 0 && iterations == 0)
+        throw std::invalid_argument("improveColoring needs a time or iteration budget");
+    int numColors = this->numColors();
+    for (size_t i = 0; i < size; i++)
+        if (vertices[i].color <= 0)
+            throw std::logic_error("improveColoring needs a colored graph");
+
+    freeze();
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = seconds > 0 ? start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds)) : std::chrono::steady_clock::time_point::max();
+    ColoringWorkspace& ws = ownWorkspace();
+    prepareWorkspace(ws);
+
+    int* best = new int[size];
+    int* current = new int[size];
+    for (size_t i = 0; i < size; i++)
+        best[i] = current[i] = vertices[i].color;
+    int bestColors = numColors;
+    int currentColors = numColors;
+
+    const size_t STALL = 20; //greedy passes without a new best before TabuCol is tried
+    size_t stall = 0;
+    for (size_t pass = 0; (iterations == 0 || pass < iterations) && std::chrono::steady_clock::now() < deadline && bestColors > 1; pass++)
+    {
+        //Culberson's mix of class orders: reverse 5, largest first 5, random 3
+        uint32_t pick = rng.bounded(13);
+        classOrder(current, currentColors, pick < 5 ? 0 : pick < 10 ? 1 : 2, ws.order, rng);
+        colorList(ws);
+        std::copy(ws.colors, ws.colors + size, current);
+        currentColors = *std::max_element(current, current + size);
+
+        if (currentColors < bestColors)
+        {
+            std::copy(current, current + size, best);
+            bestColors = currentColors;
+            stall = 0;
+        }
+        else if (useTabu && ++stall >= STALL)
+        {
+            //Try for one color less from the best coloring. The greedy passes then carry on from the best coloring either way,
+            //which is TabuCol's when it succeeds, since a failed search leaves conflicts in current
+            stall = 0;
+            std::copy(best, best + size, current);
+            if (tabuCol(current, bestColors - 1, std::max<size_t>(100000, 10 * size), deadline, rng))
+            {
+                std::copy(current, current + size, best);
+                bestColors--;
+            }
+            std::copy(best, best + size, current);
+            currentColors = bestColors;
+        }
+    }
+
+    for (size_t i = 0; i < size; i++)
+        vertices[i].color = best[i];
+
+    //The order lists the color classes one after another, first fit in that order gives back the same count
+    classOrder(best, bestColors, 3, ws.order, rng);
+    ColoringResult result;
+    result.colors.assign(best, best + size);
+    result.order.assign(ws.order, ws.order + size);
+    result.numColors = bestColors;
+    delete[] best;
+    delete[] current;
+
+    auto colored = std::chrono::steady_clock::now();
+    if (report != nullptr)
+        printColoring(result);
+    auto printed = std::chrono::steady_clock::now();
+    phaseTimes.ordering = 0;
+    phaseTimes.coloring = std::chrono::duration<double>(colored - start).count();
+    phaseTimes.output = std::chrono::duration<double>(printed - colored).count();
+    if (dynamic)
+        trackColoring();
+    return result;
+}
+
+void AdjacencyList::classOrder(const int* colors, int numColors, int rule, int* order, Rng& rng) const
+{
+    //Fills order with the vertices grouped by color class, the classes in the order of rule:
+    //0 reverse, 1 largest first, 2 random, 3 ascending. Each class keeps its vertices in id order
+    std::vector<int> classSize(numColors + 1, 0);
+    for (size_t i = 0; i < size; i++)
+        classSize[colors[i]]++;
+
+    std::vector<int> classes(numColors);
+    for (int c = 0; c < numColors; c++)
+        classes[c] = c + 1;
+    if (rule == 0)
+        std::reverse(classes.begin(), classes.end());
+    else if (rule == 1)
+        std::stable_sort(classes.begin(), classes.end(), [&](int a, int b) { return classSize[a] > classSize[b]; });
+    else if (rule == 2)
+        for (int i = numColors - 1; i > 0; i--)
+            std::swap(classes[i], classes[rng.bounded(i + 1)]);
+
+    //Counting sort, start[c] is where class c begins in order
+    std::vector<size_t> start(numColors + 1);
+    size_t pos = 0;
+    for (int c : classes)
+    {
+        start[c] = pos;
+        pos += classSize[c];
+    }
+    for (size_t i = 0; i < size; i++)
+        order[start[colors[i]]++] = i;
+}
+
+bool AdjacencyList::tabuCol(int* colors, int numColors, size_t maxMoves, std::chrono::steady_clock::time_point deadline, Rng& rng) const
+{
+    //TabuCol (Hertz and de Werra) looking for a coloring with numColors colors
+    //Vertices with a higher color start in a random one, then the search moves one conflicting vertex at a time to the color
+    //that removes the most conflicts, and moving it back is tabu for a while. On success colors holds the new coloring
+    //gamma[v * k + c] is the number of neighbors of v with color c, so every move is scored in O(1)
+    size_t k = numColors + 1;
+    if (numColors < 2 || size * k > ((size_t)1 << 26))
+        return false; //gamma and the tabu list would not fit comfortably
+
+    int* gamma = new int[size * k]();
+    int* tabu = new int[size * k]();
+    int* conflicting = new int[size]; //vertices with a neighbor of the same color
+    int* position = new int[size]; //index in conflicting, -1 if absent
+    size_t numConflicting = 0;
+
+    for (size_t v = 0; v < size; v++)
+        if (colors[v] > numColors)
+            colors[v] = 1 + rng.bounded(numColors);
+    for (size_t v = 0; v < size; v++)
+        for (size_t j = offsets[v]; j < offsets[v + 1]; j++)
+            gamma[v * k + colors[adjacency[j]]]++;
+
+    long long conflicts = 0; //every conflicting edge is counted from both ends
+    for (size_t v = 0; v < size; v++)
+    {
+        position[v] = -1;
+        int own = gamma[v * k + colors[v]];
+        conflicts += own;
+        if (own > 0)
+        {
+            position[v] = numConflicting;
+            conflicting[numConflicting++] = v;
+        }
+    }
+    conflicts /= 2;
 
-    colorList(order);
+    auto setConflicting = [&](int v) {
+        bool is = gamma[v * k + colors[v]] > 0;
+        if (is && position[v] == -1)
+        {
+            position[v] = numConflicting;
+            conflicting[numConflicting++] = v;
+        }
+        else if (!is && position[v] != -1)
+        {
+            int last = conflicting[--numConflicting];
+            conflicting[position[v]] = last;
+            position[last] = position[v];
+            position[v] = -1;
+        }
+    };
+
+    long long bestConflicts = conflicts;
+    for (size_t move = 1; move <= maxMoves && conflicts > 0; move++)
+    {
+        if (move % 256 == 0 && std::chrono::steady_clock::now() >= deadline)
+            break;
+
+        //Best non tabu move, a tabu move is still allowed if it beats the best conflict count so far
+        int bestV = -1, bestC = -1, bestDelta = INT_MAX, ties = 0;
+        for (size_t i = 0; i < numConflicting; i++)
+        {
+            int v = conflicting[i];
+            const int* g = gamma + v * k;
+            int own = g[colors[v]];
+            for (int c = 1; c <= numColors; c++)
+            {
+                if (c == colors[v])
+                    continue;
+                int delta = g[c] - own;
+                if (tabu[v * k + c] >= (int)move && conflicts + delta >= bestConflicts)
+                    continue;
+                if (delta < bestDelta)
+                {
+                    bestV = v;
+                    bestC = c;
+                    bestDelta = delta;
+                    ties = 1;
+                }
+                else if (delta == bestDelta && rng.bounded(++ties) == 0)
+                {
+                    bestV = v;
+                    bestC = c;
+                }
+            }
+        }
+        if (bestV == -1)
+        {
+            //Everything is tabu, make a random move
+            bestV = conflicting[rng.bounded(numConflicting)];
+            bestC = 1 + rng.bounded(numColors - 1);
+            if (bestC >= colors[bestV])
+                bestC++;
+            bestDelta = gamma[bestV * k + bestC] - gamma[bestV * k + colors[bestV]];
+        }
 
-    delete[] order;
+        int old = colors[bestV];
+        colors[bestV] = bestC;
+        conflicts += bestDelta;
+        for (size_t j = offsets[bestV]; j < offsets[bestV + 1]; j++)
+        {
+            int u = adjacency[j];
+            gamma[u * k + old]--;
+            gamma[u * k + bestC]++;
+            if (colors[u] == old || colors[u] == bestC)
+                setConflicting(u);
+        }
+        setConflicting(bestV);
+        tabu[bestV * k + old] = move + (int)(0.6 * numConflicting) + rng.bounded(10);
+        bestConflicts = std::min(bestConflicts, conflicts);
+    }
+
+    delete[] gamma;
+    delete[] tabu;
+    delete[] conflicting;
+    delete[] position;
+    return conflicts == 0;
+}
+
+void AdjacencyList::startDynamicColoring(AdjacencyList::Coloring algorithm, int recolorThreshold, size_t kempeLimit)
+{
+    if (directed)
+        throw std::logic_error("Dynamic coloring needs an undirected graph");
+
+    stopDynamicColoring();
+    dynamicAlgorithm = algorithm;
+    this->recolorThreshold = recolorThreshold;
+    this->kempeLimit = kempeLimit;
+    fullRecolors = 0;
+    classSize = new int[size + 2];
+    colorStamp = new size_t[size + 2]();
+    colorWitness = new int[size + 2];
+    visitStamp = new size_t[size]();
+    stamp = 0;
+    dynamic = true;
+
+    //colorGraph calls trackColoring once it is done
+    colorGraph(algorithm);
+    thaw(); //updates go to the neighbor lists from here on
+}
+
+void AdjacencyList::stopDynamicColoring()
+{
+    //The coloring is left as it is
+    dynamic = false;
+    delete[] classSize;
+    delete[] colorStamp;
+    delete[] colorWitness;
+    delete[] visitStamp;
+    classSize = nullptr;
+    colorStamp = nullptr;
+    colorWitness = nullptr;
+    visitStamp = nullptr;
+}
+
+size_t AdjacencyList::fullRecolorCount() const
+{
+    return fullRecolors;
+}
+
+void AdjacencyList::trackColoring()
+{
+    //Starts tracking a fresh full coloring
+    for (size_t c = 0; c < size + 2; c++)
+        classSize[c] = 0;
+    topColor = 0;
+    for (size_t i = 0; i < size; i++)
+    {
+        classSize[vertices[i].color]++;
+        topColor = std::max(topColor, vertices[i].color);
+    }
+    baselineColors = topColor;
+}
+
+void AdjacencyList::setColor(int v, int color)
+{
+    //Moves v to another color class, -1 leaves it uncolored
+    if (vertices[v].color > 0)
+        classSize[vertices[v].color]--;
+    vertices[v].color = color;
+    if (color > 0)
+    {
+        classSize[color]++;
+        topColor = std::max(topColor, color);
+    }
+    while (topColor > 0 && classSize[topColor] == 0)
+        topColor--;
+}
+
+void AdjacencyList::scanNeighborColors(int v)
+{
+    //Marks the colors around v, colorWitness[c] is the only neighbor with color c or -2 if there are more
+    stamp++;
+    for (auto iter = vertices[v].neighbors.begin(); !iter.isEnd(); iter++)
+    {
+        int c = vertices[*iter].color;
+        if (c <= 0)
+            continue;
+        colorWitness[c] = colorStamp[c] == stamp ? -2 : *iter;
+        colorStamp[c] = stamp;
+    }
+    GRAPH_COUNT(stats.neighborsVisited, vertices[v].neighbors.size());
+}
+
+bool AdjacencyList::kempeRepair(int v)
+{
+    //v is uncolored and every color up to topColor is taken by a neighbor
+    //If color b is taken by a single neighbor x, swapping b and c along the chain of b and c colored vertices through x
+    //frees b for v, as long as the chain never reaches a neighbor of v colored c
+    //Only chains of at most kempeLimit vertices are tried
+    scanNeighborColors(v);
+    std::vector<int> chain;
+    for (int b = 1; b <= topColor; b++)
+    {
+        int x = colorWitness[b];
+        if (x < 0)
+            continue;
+
+        for (int c = 1; c <= topColor; c++)
+        {
+            if (c == b)
+                continue;
+
+            //Breadth first walk of the chain through x, chain doubles as the queue
+            stamp++;
+            chain.clear();
+            chain.push_back(x);
+            visitStamp[x] = stamp;
+            bool usable = true;
+            for (size_t i = 0; i < chain.size() && usable; i++)
+            {
+                for (auto iter = vertices[chain[i]].neighbors.begin(); !iter.isEnd(); iter++)
+                {
+                    int u = *iter;
+                    int uc = vertices[u].color;
+                    if ((uc != b && uc != c) || visitStamp[u] == stamp)
+                        continue;
+                    if (chain.size() == kempeLimit || (uc == c && hasEdge(u, v)))
+                    {
+                        usable = false;
+                        break;
+                    }
+                    visitStamp[u] = stamp;
+                    chain.push_back(u);
+                }
+            }
+            if (!usable)
+                continue;
+
+            for (int u : chain)
+                setColor(u, vertices[u].color == b ? c : b);
+            setColor(v, b);
+            return true;
+        }
+    }
+    return false;
+}
+
+void AdjacencyList::repairEdge(int v1, int v2)
+{
+    //Fixes the conflict a new edge may have caused by recoloring the endpoint with the smaller degree
+    if (vertices[v1].color != vertices[v2].color)
+        return;
+
+    int v = vertices[v1].neighbors.size() <= vertices[v2].neighbors.size() ? v1 : v2;
+    setColor(v, -1);
+    scanNeighborColors(v);
+    int color = 1;
+    while (color <= topColor && colorStamp[color] == stamp)
+        color++;
+
+    if (color <= topColor || kempeLimit == 0 || !kempeRepair(v))
+        setColor(v, color);
+
+    if (topColor > baselineColors + recolorThreshold)
+        fullRecolor();
+}
+
+void AdjacencyList::lowerColor(int v)
+{
+    //Moves v to the smallest color none of its neighbors has, if that is below its current one
+    scanNeighborColors(v);
+    int color = 1;
+    while (color < vertices[v].color && colorStamp[color] == stamp)
+        color++;
+    if (color < vertices[v].color)
+        setColor(v, color);
+}
+
+void AdjacencyList::fullRecolor()
+{
+    //The color count has drifted too far from what the full algorithm gets, start over from scratch
+    //colorGraph freezes the graph and calls trackColoring
+    fullRecolors++;
+    colorGraph(dynamicAlgorithm);
+    thaw();
 }
 
 void AdjacencyList::conflictHist(std::string filename)
 {
     //Outputs histogram of conflicts for each vertex
-    std::ofstream file(filename);
-    file << "vertex,numEdges" << std::endl;
+    freeze();
+    OutputWriter file(filename, asyncOutput);
+    file << "vertex,numEdges\n";
     for (size_t i = 0; i < size; i++)
-        file << i << "," << vertices[i].neighbors.size() << std::endl;
+        file << i << ',' << degree(i) << '\n';
+    file.close();
 }
\ No newline at end of file
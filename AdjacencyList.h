@@ -1,8 +1,19 @@
 #pragma once
 #include "LinkedList.h"
 #include "RandomGen.h"
+#include "Rng.h"
+#include "PairSet.h"
+#include "BitMatrix.h"
+#include "DegreeBuckets.h"
+#include "IndexedHeap.h"
+#include "ColoringWorkspace.h"
+#include "ThreadPool.h"
+#include "GraphStats.h"
+#include "OutputWriter.h"
+#include <chrono>
 #include <fstream>
 #include <string>
+#include <vector>
 #include <iostream>
 
 //This source code is original, but I did look here for reference:
@@ -10,6 +21,66 @@
 
 class AdjacencyList {
 
+public:
+
+    enum class Distribution {
+        UNIFORM,
+        SKEWED,
+        NORMAL
+    };
+
+    enum class Coloring {
+        SLVO,
+        SODL,
+        RANDOM,
+        LLVO,
+        LODL,
+        IN_ORDER,
+        JONES_PLASSMANN, //parallel, random priorities, undirected graphs only
+        JONES_PLASSMANN_LDF, //parallel, largest degree first with random tie breaks, undirected graphs only
+        DSATUR, //most distinct neighbor colors next, ties to the most uncolored neighbors
+        RLF //recursive largest first, one maximal independent set per color
+    };
+
+    //Outcome of a coloring run
+    struct ColoringResult
+    {
+        std::vector<int> colors; //color of each vertex id, starting at 1
+        std::vector<int> order; //vertices in the order they were colored
+        std::vector<int> degreeWhenDeleted; //parallel to order, only filled by SLVO and LLVO
+        int numColors = 0;
+        int maxDegreeWhenDeleted = 0; //SLVO and LLVO only
+        int terminalCliqueSize = 0; //SLVO only
+        int rounds = 0; //colorGraphSpeculative only, tentative coloring and conflict detection passes
+        size_t conflicts = 0; //colorGraphSpeculative only, vertices that had to be recolored over all rounds
+    };
+
+    //Outcome of colorPortfolio
+    struct PortfolioResult
+    {
+        ColoringResult best; //fewest colors of the runs that finished, empty if none did
+        AdjacencyList::Coloring algorithm = AdjacencyList::Coloring::SLVO; //run that produced best
+        size_t runsFinished = 0;
+        size_t runsCancelled = 0; //stopped by the deadline or by a run reaching the lower bound, including runs never started
+        int lowerBound = 0; //highest lower bound known when the portfolio ended
+    };
+
+    //Wall clock seconds spent in each phase of the last colorGraph or colorGraphSpeculative call
+    struct PhaseTimes
+    {
+        double ordering = 0; //building the vertex ordering, 0 for Jones-Plassmann which has none
+        double coloring = 0;
+        double output = 0; //printing the coloring and the summaries
+    };
+
+    //Structure backing hasEdge once the graph is frozen
+    enum class EdgeIndex {
+        AUTO, //picked by freeze() from the density
+        SORTED, //binary search in the sorted CSR row
+        HASH, //open addressing hash of packed (v1, v2) keys
+        DENSE //bit row per vertex, also enables the bitset coloring kernel
+    };
+
 private:
 
     class Node {
@@ -17,11 +88,7 @@ private:
 
         int id;
         int color = -1; //assigned color
-        int currentDegree; //current degree during coloring process
-        int originalDegree; //degree in the original graph
-        bool deleted; //marks if removed by coloring algo
         LinkedList<int> neighbors;
-        LinkedList<int>::ListIter degreePtr;
 
     public:
 
@@ -31,67 +98,176 @@ private:
         friend class AdjacencyList;
         bool hasNeighbor(int id) const;
         void addNeighbor(int id);
+        void removeNeighbor(int id);
 
     };
 
-    Node* vertices;
-    LinkedList<int>* degreeList; //adj list representing degree list of each vertex
-    bool directed; //true if the graph is a directed graph
-    size_t size;
-    double averageOriginalDegree = 0;
+    Node* vertices = nullptr;
+    NodePool<int>* neighborPool = nullptr; //backs every neighbors list while the graph is not frozen
+    bool directed = false; //true if the graph is a directed graph
+    size_t size = 0;
 
-    bool* edges; //look-up table to check edge existence. Edge v1->v2 exists if (|V|*v1 + v2) is true
+    //Compressed sparse row form of the neighbor lists, built by freeze()
+    //Neighbors of v are adjacency[offsets[v]] ... adjacency[offsets[v+1] - 1]
+    bool frozen = false;
+    size_t* offsets = nullptr; //size + 1 entries
+    int* adjacency = nullptr; //one entry per directed edge
+    void* mapping = nullptr; //set when offsets and adjacency point into an mmap'ed binary file
+    size_t mappingLength = 0;
+
+    //Edge existence index, edgeSet and sorted rows are O(V + E) in memory
+    //While the graph is being built edgeSet always holds every edge (normalized to v1 <= v2 when undirected)
+    PairSet* edgeSet = nullptr; //null when frozen with sorted rows or bit rows as the index
+    BitMatrix* dense = nullptr; //one bit row per vertex, only for frozen dense graphs
+
+    ThreadPool* threadPool = nullptr; //created on first use by the parallel algorithms
+    ColoringWorkspace* workspace = nullptr; //created on first use by the colorings that are not given one
+    size_t numThreads = 0; //0 uses every hardware thread
+    PhaseTimes phaseTimes;
+    std::ostream* report = nullptr; //where colorings are printed, nothing is printed or written when null
+    bool asyncOutput = false; //files are written by the background writer, see OutputWriter.h
+    mutable GraphStats stats; //mutable so hasEdge can count its probes, see GraphStats.h
+    Rng rng; //drives the RANDOM ordering and the Jones-Plassmann priorities, seeded from std::random_device unless setSeed is called
+
+    //Dynamic coloring, see startDynamicColoring
+    bool dynamic = false;
+    AdjacencyList::Coloring dynamicAlgorithm = AdjacencyList::Coloring::SLVO; //used for the full recolors
+    int recolorThreshold = 0; //colors allowed above baselineColors before a full recolor
+    size_t kempeLimit = 0; //most vertices a Kempe chain may have, 0 turns the repair off
+    int* classSize = nullptr; //vertices of each color, size + 2 entries
+    int topColor = 0; //highest color in use
+    int baselineColors = 0; //colors used right after the last full recolor
+    size_t fullRecolors = 0;
+    size_t* colorStamp = nullptr; //colorStamp[c] == stamp when a neighbor of the vertex being recolored has color c
+    int* colorWitness = nullptr; //that neighbor, or -2 when there are several
+    size_t* visitStamp = nullptr; //Kempe chain membership, one entry per vertex
+    size_t stamp = 0;
 
     //Private methods and coloring algos
-    void delVertex(int v);
-    void colorList(int* order, int* degWhenDel=nullptr);
-    void outputFile(std::string filename);
+    size_t degree(int v) const;
+    void buildFromDense();
+    void releaseCsr();
+    void buildIndex(AdjacencyList::EdgeIndex index);
+    void hashEdges();
+    void loadSortedEdges(const uint64_t* edges, size_t numEdges);
+    ThreadPool& pool();
+    ColoringWorkspace& ownWorkspace();
+    void printColoring(const ColoringResult& result);
 
-    void SLVO();
-    void SODL();
-    void RANDOM();
-    void LLVO();
-    void LODL();
-    void inOrder();
+    //The coloring algos only read the graph, everything they write is in the workspace or the arrays passed in
+    void prepareWorkspace(ColoringWorkspace& ws) const;
+    bool runColoring(AdjacencyList::Coloring algorithm, ColoringWorkspace& ws, Rng& rng, PhaseTimes& times);
+    ColoringResult collectResult(AdjacencyList::Coloring algorithm, const int* order, const int* colors, const int* degWhenDel) const;
+    static int terminalClique(const int* degWhenDel, size_t size);
+    void delVertex(int v, DegreeBuckets& buckets) const;
+    void colorList(ColoringWorkspace& ws) const;
+    void colorDense(const int* order, int* colors) const;
+    void dsatur(ColoringWorkspace& ws) const;
+    void rlf(ColoringWorkspace& ws) const;
+
+    void SLVO(ColoringWorkspace& ws) const;
+    void SODL(const DegreeBuckets& buckets, int* order) const;
+    void RANDOM(int* order, Rng& rng) const;
+    void LLVO(ColoringWorkspace& ws) const;
+    void LODL(const DegreeBuckets& buckets, int* order) const;
+    void inOrder(int* order) const;
+    bool buildOrder(AdjacencyList::Coloring algorithm, ColoringWorkspace& ws, Rng& rng) const;
+    void slvoSummary(const ColoringResult& result);
+    void jonesPlassmann(bool largestDegreeFirst, int* order, int* colors, uint64_t seed);
+    void classOrder(const int* colors, int numColors, int rule, int* order, Rng& rng) const;
+    bool tabuCol(int* colors, int numColors, size_t maxMoves, std::chrono::steady_clock::time_point deadline, Rng& rng) const;
+
+    //Dynamic coloring helpers
+    void trackColoring();
+    void setColor(int v, int color);
+    void scanNeighborColors(int v);
+    bool kempeRepair(int v);
+    void repairEdge(int v1, int v2);
+    void lowerColor(int v);
+    void fullRecolor();
 
 public:
 
     //Constructors
     AdjacencyList() = default;
     AdjacencyList(size_t numVertices, bool isDirected=false);
-    AdjacencyList(std::string filename, bool isDirected=false);
+    AdjacencyList(std::string filename, bool isDirected=false, size_t numThreads=0);
     ~AdjacencyList();
-
-    enum class Distribution {
-        UNIFORM,
-        SKEWED,
-        NORMAL
-    };
-
-    enum class Coloring {
-        SLVO,
-        SODL,
-        RANDOM,
-        LLVO,
-        LODL,
-        IN_ORDER
-    };
+    //The graph owns its arrays, so it can be moved but not copied. The graph moved from is left empty
+    AdjacencyList(const AdjacencyList&) = delete;
+    AdjacencyList& operator=(const AdjacencyList&) = delete;
+    AdjacencyList(AdjacencyList&& other) noexcept;
+    AdjacencyList& operator=(AdjacencyList&& other) noexcept;
 
     //Named constructors
     static AdjacencyList createCycle(size_t numVertices);
     static AdjacencyList createCompleteGraph(size_t numVertices);
     static AdjacencyList createRandomGraph(size_t numVertices, size_t numEdges, AdjacencyList::Distribution dist);
+    //The seeded generators draw from rng and advance it, so a fixed seed reproduces the same sequence of graphs
+    //whatever numThreads is, the thread count only changes how fast the skewed and normal graphs are drawn
+    static AdjacencyList createRandomGraph(size_t numVertices, size_t numEdges, AdjacencyList::Distribution dist, Rng& rng, size_t numThreads=0);
+    static AdjacencyList createGnm(size_t numVertices, size_t numEdges, Rng& rng); //uniform, exactly numEdges edges
+    static AdjacencyList createGnp(size_t numVertices, double p, Rng& rng); //each edge with probability p
+    static AdjacencyList loadBinary(std::string filename); //throws std::runtime_error if the file is malformed
+
+    //Converters between the text .graph format and the binary format
+    static void convertToBinary(std::string textFile, std::string binaryFile, bool isDirected=false);
+    static void convertToText(std::string binaryFile, std::string textFile);
 
     //Methods
     void addEdge(int v1, int v2);
+    void removeEdge(int v1, int v2); //does nothing if the edge is not there
+    void freeze(AdjacencyList::EdgeIndex index=AdjacencyList::EdgeIndex::AUTO);
+    void thaw();
+    bool isFrozen() const;
     void print();
     void save(std::string filename);
-    void genDegreeList();
+    void saveBinary(std::string filename);
+    size_t E();
     bool hasEdge(int v1, int v2) const;
     size_t V();
     void conflictHist(std::string filename);
+    void outputFile(std::string filename); //vertex,color rows of the last coloring to filename.csv
+    void setNumThreads(size_t n);
+    void setSeed(uint64_t seed);
+    void setReport(std::ostream* sink); //prints every coloring to sink, and SLVO also writes slvo_plot.csv
+    //With async output save, conflictHist, outputFile and slvo_plot.csv return once their text is formatted and the
+    //file is written in the background. Call OutputWriter::drain() before reading any of them back
+    void setAsyncOutput(bool async);
+    int numColors() const; //highest color assigned, 0 if the graph has not been colored
+    const PhaseTimes& lastPhaseTimes() const;
+
+    //Hot path counters and phase timers since construction or the last resetStats, all 0 unless built with -DGRAPH_STATS
+    GraphStats getStats() const;
+    void resetStats();
+    void saveStats(std::string filename) const; //as JSON
 
     //Coloring methods
-    void colorGraph(AdjacencyList::Coloring algorithm);
+    //The graph is left as it is apart from the colors it holds, so it can be colored again with any algorithm
+    ColoringResult colorGraph(AdjacencyList::Coloring algorithm);
+    ColoringResult colorGraph(AdjacencyList::Coloring algorithm, ColoringWorkspace& ws); //scratch arrays come from ws
+    ColoringResult colorGraphSpeculative(AdjacencyList::Coloring ordering);
+
+    //Runs every algorithm in algorithms plus randomRestarts more RANDOM orderings side by side on the worker threads, each
+    //with its own workspace and random stream, and keeps the coloring with the fewest colors
+    //Runs still going are cancelled once deadlineSeconds have passed (0 is no deadline) or as soon as one run uses only
+    //lowerBound colors. The bound is raised to the terminal clique size of every SLVO run, so list SLVO first
+    //Jones-Plassmann is parallel on its own and cannot be part of a portfolio
+    PortfolioResult colorPortfolio(const std::vector<AdjacencyList::Coloring>& algorithms, size_t randomRestarts=0, double deadlineSeconds=0, int lowerBound=0);
+
+    //Tries to lower the color count of the current coloring and keeps the best one found
+    //Iterated greedy (Culberson) recolors first fit with whole color classes in reverse, largest first or random order,
+    //which never needs more colors. When that stalls, TabuCol searches for a coloring with one color less
+    //Stops after seconds (0 is no limit) or iterations greedy passes (0 is no limit), at least one of them must be set
+    ColoringResult improveColoring(double seconds, size_t iterations=0, bool useTabu=true);
+
+    //Dynamic coloring, undirected graphs only
+    //Colors the graph with algorithm, then addEdge and removeEdge keep the coloring valid by recoloring one endpoint
+    //of a new conflict, so an update costs about the degrees of its endpoints. A Kempe chain swap of at most kempeLimit
+    //vertices is tried before a new color is opened, and once more than recolorThreshold colors have been added since the
+    //last full coloring the whole graph is colored again with algorithm
+    void startDynamicColoring(AdjacencyList::Coloring algorithm, int recolorThreshold=2, size_t kempeLimit=64);
+    void stopDynamicColoring();
+    size_t fullRecolorCount() const; //full recolors since startDynamicColoring, not counting the first coloring
 
 };
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "BitMatrix.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <immintrin.h>
+
+//Intersection kernels, picked once at startup from what the CPU supports
+
+static bool intersectsScalar(const uint64_t* a, const uint64_t* b, size_t from, size_t to)
+{
+    for (size_t w = from; w < to; w++)
+        if (a[w] & b[w])
+            return true;
+    return false;
+}
+
+__attribute__((target("avx2")))
+static bool intersectsAvx2(const uint64_t* a, const uint64_t* b, size_t from, size_t to)
+{
+    size_t w = from;
+    for (; w + 4 <= to; w += 4)
+    {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + w));
+        __m256i y = _mm256_loadu_si256((const __m256i*)(b + w));
+        if (!_mm256_testz_si256(x, y))
+            return true;
+    }
+    return intersectsScalar(a, b, w, to);
+}
+
+__attribute__((target("avx512f")))
+static bool intersectsAvx512(const uint64_t* a, const uint64_t* b, size_t from, size_t to)
+{
+    size_t w = from;
+    for (; w + 8 <= to; w += 8)
+    {
+        __m512i x = _mm512_loadu_si512((const void*)(a + w));
+        __m512i y = _mm512_loadu_si512((const void*)(b + w));
+        if (_mm512_test_epi64_mask(x, y))
+            return true;
+    }
+    return intersectsScalar(a, b, w, to);
+}
+
+typedef bool (*IntersectFn)(const uint64_t*, const uint64_t*, size_t, size_t);
+
+static IntersectFn pickIntersect()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return intersectsAvx512;
+    if (__builtin_cpu_supports("avx2"))
+        return intersectsAvx2;
+    return intersectsScalar;
+}
+
+static const IntersectFn intersectImpl = pickIntersect();
+
+BitMatrix::BitMatrix(size_t n): n(n)
+{
+    rowWords = wordsFor(n);
+    bits = allocRow(rowWords * n);
+}
+
+BitMatrix::~BitMatrix()
+{
+    freeRow(bits);
+}
+
+size_t BitMatrix::wordsFor(size_t numBits)
+{
+    size_t words = (numBits + 63) / 64;
+    return (words + 7) & ~(size_t)7;
+}
+
+uint64_t* BitMatrix::allocRow(size_t words)
+{
+    if (words == 0)
+        words = 8;
+    void* p = std::aligned_alloc(64, words * sizeof(uint64_t));
+    if (p == nullptr)
+        throw std::bad_alloc();
+    std::memset(p, 0, words * sizeof(uint64_t));
+    return (uint64_t*)p;
+}
+
+void BitMatrix::freeRow(uint64_t* row)
+{
+    std::free(row);
+}
+
+bool BitMatrix::intersects(const uint64_t* a, const uint64_t* b, size_t from, size_t to)
+{
+    return intersectImpl(a, b, from, to);
+}
+
+void BitMatrix::set(size_t r, size_t c)
+{
+    bits[r * rowWords + c / 64] |= 1ULL << (c % 64);
+}
+
+bool BitMatrix::test(size_t r, size_t c) const
+{
+    return (bits[r * rowWords + c / 64] >> (c % 64)) & 1;
+}
+
+size_t BitMatrix::rowCount(size_t r) const
+{
+    const uint64_t* p = row(r);
+    size_t count = 0;
+    for (size_t w = 0; w < rowWords; w++)
+        count += __builtin_popcountll(p[w]);
+    return count;
+}
+
+const uint64_t* BitMatrix::row(size_t r) const
+{
+    return bits + r * rowWords;
+}
+
+size_t BitMatrix::words() const
+{
+    return rowWords;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+//Square bit matrix stored as one bit row per vertex
+//Rows are padded to a multiple of 8 words (64 bytes) and 64 byte aligned so the SIMD kernels can use aligned loads
+
+class BitMatrix
+{
+
+private:
+
+    uint64_t* bits;
+    size_t n; //number of rows and columns
+    size_t rowWords; //words per padded row
+
+public:
+
+    BitMatrix(size_t n);
+    ~BitMatrix();
+
+    static size_t wordsFor(size_t numBits);
+    static uint64_t* allocRow(size_t words); //zeroed, aligned, release with freeRow
+    static void freeRow(uint64_t* row);
+
+    //True if a & b has a set bit in words [from, to). Uses AVX-512 or AVX2 when the CPU has it
+    static bool intersects(const uint64_t* a, const uint64_t* b, size_t from, size_t to);
+
+    void set(size_t r, size_t c);
+    bool test(size_t r, size_t c) const;
+    size_t rowCount(size_t r) const; //popcount of row r
+    const uint64_t* row(size_t r) const;
+    size_t words() const;
+
+};
@@ -0,0 +1,58 @@
+#include "ColoringWorkspace.h"
+
+ColoringWorkspace::~ColoringWorkspace()
+{
+    release();
+}
+
+void ColoringWorkspace::reserve(size_t numVertices, size_t numBuckets)
+{
+    //Keeps the arrays when they are big enough, the buckets are then only emptied, O(V + buckets)
+    //An empty graph still gets its arrays, forbidden always has numVertices + 2 entries
+    if (order == nullptr || numVertices > this->numVertices)
+    {
+        release();
+        order = new int[numVertices];
+        degreeWhenDel = new int[numVertices];
+        colors = new int[numVertices];
+        forbidden = new int[numVertices + 2];
+        this->numVertices = numVertices;
+    }
+
+    if (buckets == nullptr || numBuckets > this->numBuckets)
+    {
+        delete buckets;
+        buckets = new DegreeBuckets(this->numVertices, numBuckets);
+        this->numBuckets = numBuckets;
+    }
+    else
+        buckets->clear();
+}
+
+bool ColoringWorkspace::checkStop()
+{
+    if ((cancel != nullptr && cancel->load(std::memory_order_relaxed)) || std::chrono::steady_clock::now() >= deadline)
+        stopped = true;
+    return stopped;
+}
+
+size_t ColoringWorkspace::capacity() const
+{
+    return numVertices;
+}
+
+void ColoringWorkspace::release()
+{
+    delete buckets;
+    delete[] order;
+    delete[] degreeWhenDel;
+    delete[] colors;
+    delete[] forbidden;
+    buckets = nullptr;
+    order = nullptr;
+    degreeWhenDel = nullptr;
+    colors = nullptr;
+    forbidden = nullptr;
+    numVertices = 0;
+    numBuckets = 0;
+}
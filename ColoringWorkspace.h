@@ -0,0 +1,48 @@
+#pragma once
+#include "DegreeBuckets.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+//Everything a coloring run writes: the degree buckets the orderings consume, the ordering itself and the colors
+//The coloring algorithms only read the graph's arrays, so one loaded graph can be colored any number of times, and
+//their inner runs with separate workspaces can go side by side, as colorPortfolio does. colorGraph itself is not isolated:
+//it freezes the graph, stores the colors on its vertices and updates its phase times and stats, and Jones-Plassmann
+//runs on the graph's shared thread pool
+//The arrays are kept between runs and only reallocated when a larger graph needs them
+
+class ColoringWorkspace
+{
+
+private:
+
+    size_t numVertices = 0;
+    size_t numBuckets = 0;
+    DegreeBuckets* buckets = nullptr; //current degree of each vertex not yet removed by SLVO or LLVO
+    int* order = nullptr;
+    int* degreeWhenDel = nullptr; //parallel to order, SLVO and LLVO only
+    int* colors = nullptr; //color of each vertex id
+    int* forbidden = nullptr; //first fit scratch, numVertices + 2 entries
+
+    //A run stops early once cancel is set or the deadline passes, and stopped tells the caller its output is incomplete
+    const std::atomic<bool>* cancel = nullptr;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    bool stopped = false;
+
+    void reserve(size_t numVertices, size_t numBuckets);
+    bool checkStop(); //polled every STOP_CHECK vertices by the long loops
+    static const size_t STOP_CHECK = 1024;
+
+    friend class AdjacencyList;
+
+public:
+
+    ColoringWorkspace() = default;
+    ~ColoringWorkspace();
+    ColoringWorkspace(const ColoringWorkspace&) = delete;
+    ColoringWorkspace& operator=(const ColoringWorkspace&) = delete;
+
+    size_t capacity() const; //vertices the arrays have room for
+    void release(); //frees the arrays, the next run allocates them again
+
+};
@@ -0,0 +1,89 @@
+#include "DegreeBuckets.h"
+
+DegreeBuckets::DegreeBuckets(size_t numVertices, size_t numBuckets): numVertices(numVertices), numBuckets(numBuckets), count(0)
+{
+    head = new int[numBuckets];
+    next = new int[numVertices];
+    prev = new int[numVertices];
+    key = new int[numVertices];
+    clear();
+}
+
+DegreeBuckets::~DegreeBuckets()
+{
+    delete[] head;
+    delete[] next;
+    delete[] prev;
+    delete[] key;
+}
+
+void DegreeBuckets::clear()
+{
+    for (size_t i = 0; i < numBuckets; i++)
+        head[i] = -1;
+    for (size_t i = 0; i < numVertices; i++)
+        key[i] = -1;
+    count = 0;
+}
+
+void DegreeBuckets::insert(int v, int bucket)
+{
+    int h = head[bucket];
+    next[v] = h;
+    prev[v] = -1;
+    if (h != -1)
+        prev[h] = v;
+    head[bucket] = v;
+    key[v] = bucket;
+    count++;
+}
+
+void DegreeBuckets::remove(int v)
+{
+    if (prev[v] != -1)
+        next[prev[v]] = next[v];
+    else
+        head[key[v]] = next[v];
+
+    if (next[v] != -1)
+        prev[next[v]] = prev[v];
+
+    key[v] = -1;
+    count--;
+}
+
+void DegreeBuckets::move(int v, int bucket)
+{
+    remove(v);
+    insert(v, bucket);
+}
+
+int DegreeBuckets::first(int bucket) const
+{
+    return head[bucket];
+}
+
+int DegreeBuckets::nextIn(int v) const
+{
+    return next[v];
+}
+
+int DegreeBuckets::bucketOf(int v) const
+{
+    return key[v];
+}
+
+bool DegreeBuckets::contains(int v) const
+{
+    return key[v] != -1;
+}
+
+size_t DegreeBuckets::size() const
+{
+    return count;
+}
+
+size_t DegreeBuckets::buckets() const
+{
+    return numBuckets;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+
+//Bucket queue of vertex ids keyed by degree
+//Each bucket is an intrusive doubly linked list threaded through arrays indexed by vertex id,
+//so insert, remove and move are O(1) and never allocate
+
+class DegreeBuckets
+{
+
+private:
+
+    int* head; //first vertex in each bucket, -1 if empty
+    int* next; //next vertex in the same bucket, -1 at the end
+    int* prev; //previous vertex in the same bucket, -1 at the front
+    int* key; //bucket each vertex is in, -1 if it is not queued
+    size_t numVertices;
+    size_t numBuckets;
+    size_t count;
+
+public:
+
+    DegreeBuckets(size_t numVertices, size_t numBuckets);
+    ~DegreeBuckets();
+
+    void insert(int v, int bucket); //inserts at the front of the bucket
+    void remove(int v);
+    void move(int v, int bucket);
+    void clear();
+
+    int first(int bucket) const; //-1 if the bucket is empty
+    int nextIn(int v) const; //next vertex after v in its bucket, -1 at the end
+    int bucketOf(int v) const;
+    bool contains(int v) const;
+    size_t size() const;
+    size_t buckets() const;
+
+};
@@ -0,0 +1,35 @@
+#include "GraphStats.h"
+#include <sstream>
+
+thread_local bool GraphStats::suspended = false;
+
+bool GraphStats::enabled()
+{
+#ifdef GRAPH_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::string GraphStats::toJson() const
+{
+    std::ostringstream out;
+    out << "{\n"
+        << "  \"enabled\": " << (enabled() ? "true" : "false") << ",\n"
+        << "  \"counters\": {\n"
+        << "    \"edgeProbes\": " << edgeProbes << ",\n"
+        << "    \"bucketMoves\": " << bucketMoves << ",\n"
+        << "    \"nodesAllocated\": " << nodesAllocated << ",\n"
+        << "    \"nodesFreed\": " << nodesFreed << ",\n"
+        << "    \"bucketsScanned\": " << bucketsScanned << ",\n"
+        << "    \"neighborsVisited\": " << neighborsVisited << "\n"
+        << "  },\n"
+        << "  \"phaseSeconds\": {\n"
+        << "    \"construction\": " << construction << ",\n"
+        << "    \"ordering\": " << ordering << ",\n"
+        << "    \"coloring\": " << coloring << "\n"
+        << "  }\n"
+        << "}\n";
+    return out.str();
+}
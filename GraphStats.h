@@ -0,0 +1,61 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+//Hot path counters and phase timers for one graph
+//Only collected when built with -DGRAPH_STATS, otherwise the macros below expand to nothing and every field stays 0
+//The counters are plain integers and are only bumped on the sequential code paths, the parallel
+//algorithms just show up in the phase timers. Threads running whole colorings side by side set suspended so they do not race
+
+struct GraphStats
+{
+    //Counters
+    uint64_t edgeProbes = 0; //edge lookups by hasEdge and addEdge
+    uint64_t bucketMoves = 0; //degree bucket moves made by delVertex
+    uint64_t nodesAllocated = 0; //neighbor list nodes taken from the pool
+    uint64_t nodesFreed = 0; //neighbor list nodes handed back to the pool
+    uint64_t bucketsScanned = 0; //degree buckets looked at by SLVO and LLVO, empty ones included
+    uint64_t neighborsVisited = 0; //adjacency entries read by delVertex and colorList
+
+    //Phase timers in seconds, summed over every call
+    double construction = 0; //loading or generating the graph
+    double ordering = 0;
+    double coloring = 0;
+
+    static thread_local bool suspended; //nothing is counted or timed on this thread while set
+
+    static bool enabled();
+    std::string toJson() const;
+};
+
+//Adds the time until the end of the enclosing scope to total
+class ScopedPhase
+{
+
+private:
+
+    double& total;
+    std::chrono::steady_clock::time_point start;
+
+public:
+
+    ScopedPhase(double& total): total(total), start(std::chrono::steady_clock::now()) {}
+    ~ScopedPhase()
+    {
+        if (!GraphStats::suspended)
+            total += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+};
+
+#define GRAPH_STATS_CONCAT2(a, b) a##b
+#define GRAPH_STATS_CONCAT(a, b) GRAPH_STATS_CONCAT2(a, b)
+
+#ifdef GRAPH_STATS
+#define GRAPH_COUNT(counter, n) (GraphStats::suspended ? (void)0 : (void)((counter) += (n)))
+#define GRAPH_PHASE(total) ScopedPhase GRAPH_STATS_CONCAT(graphPhase, __LINE__)(total)
+#else
+#define GRAPH_COUNT(counter, n) ((void)0)
+#define GRAPH_PHASE(total) ((void)0)
+#endif
@@ -0,0 +1,105 @@
+#include "IndexedHeap.h"
+
+IndexedHeap::IndexedHeap(size_t numItems): numItems(numItems), count(0)
+{
+    heap = new int[numItems];
+    position = new int[numItems];
+    key = new uint64_t[numItems];
+    for (size_t i = 0; i < numItems; i++)
+        position[i] = -1;
+}
+
+IndexedHeap::~IndexedHeap()
+{
+    delete[] heap;
+    delete[] position;
+    delete[] key;
+}
+
+void IndexedHeap::siftUp(size_t i)
+{
+    int v = heap[i];
+    while (i > 0)
+    {
+        size_t parent = (i - 1) / 2;
+        if (key[heap[parent]] >= key[v])
+            break;
+        heap[i] = heap[parent];
+        position[heap[i]] = i;
+        i = parent;
+    }
+    heap[i] = v;
+    position[v] = i;
+}
+
+void IndexedHeap::siftDown(size_t i)
+{
+    int v = heap[i];
+    while (true)
+    {
+        size_t child = 2 * i + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && key[heap[child + 1]] > key[heap[child]])
+            child++;
+        if (key[heap[child]] <= key[v])
+            break;
+        heap[i] = heap[child];
+        position[heap[i]] = i;
+        i = child;
+    }
+    heap[i] = v;
+    position[v] = i;
+}
+
+void IndexedHeap::push(int v, uint64_t k)
+{
+    key[v] = k;
+    heap[count] = v;
+    position[v] = count;
+    count++;
+    siftUp(count - 1);
+}
+
+int IndexedHeap::pop()
+{
+    int top = heap[0];
+    position[top] = -1;
+    count--;
+    if (count > 0)
+    {
+        heap[0] = heap[count];
+        siftDown(0);
+    }
+    return top;
+}
+
+void IndexedHeap::update(int v, uint64_t k)
+{
+    uint64_t old = key[v];
+    key[v] = k;
+    if (k > old)
+        siftUp(position[v]);
+    else
+        siftDown(position[v]);
+}
+
+uint64_t IndexedHeap::keyOf(int v) const
+{
+    return key[v];
+}
+
+bool IndexedHeap::contains(int v) const
+{
+    return position[v] != -1;
+}
+
+size_t IndexedHeap::size() const
+{
+    return count;
+}
+
+bool IndexedHeap::empty() const
+{
+    return count == 0;
+}
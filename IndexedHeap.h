@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+//Binary max heap of vertex ids with a 64 bit key each
+//position tracks where every id sits, so a key can be raised or lowered in O(log n) without searching for it
+
+class IndexedHeap
+{
+
+private:
+
+    int* heap; //ids in heap order
+    int* position; //index of each id in heap, -1 if it is not in the heap
+    uint64_t* key;
+    size_t numItems;
+    size_t count;
+
+    void siftUp(size_t i);
+    void siftDown(size_t i);
+
+public:
+
+    IndexedHeap(size_t numItems);
+    ~IndexedHeap();
+    IndexedHeap(const IndexedHeap&) = delete;
+    IndexedHeap& operator=(const IndexedHeap&) = delete;
+
+    void push(int v, uint64_t k);
+    int pop(); //removes and returns the id with the largest key, ties go to any of them
+    void update(int v, uint64_t k); //v must be in the heap
+    uint64_t keyOf(int v) const;
+    bool contains(int v) const;
+    size_t size() const;
+    bool empty() const;
+
+};
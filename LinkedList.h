@@ -1,5 +1,7 @@
 #pragma once
 #include <stdexcept>
+#include <new>
+#include <type_traits>
 
 //Inspired by my code from data structures class
 //And also here: https://www.codesdope.com/blog/article/c-linked-lists-in-c-singly-linked-list/
@@ -10,6 +12,7 @@ class Node {
 private:
 
     template <class U> friend class LinkedList;
+    template <class U> friend class NodePool;
 
     T data;
     Node<T>* previous;
@@ -22,6 +25,162 @@ public:
 
 };
 
+//Slab allocator for list nodes
+//Nodes are carved out of contiguous blocks, erased nodes are recycled through a free list,
+//and every block is released at once when the pool is destroyed
+template <class T>
+class NodePool {
+
+private:
+
+    struct Block
+    {
+        Block* next;
+        Node<T>* nodes;
+    };
+
+    Block* blocks;
+    Node<T>* freeList; //recycled nodes, chained through their next pointer
+    Node<T>* cursor; //next unused node in the newest block
+    Node<T>* blockEnd;
+    size_t blockSize; //nodes in the next block, doubles up to maxBlockSize
+    size_t live; //nodes handed out and not yet returned
+#ifdef GRAPH_STATS
+    size_t allocations = 0;
+    size_t deallocations = 0; //includes nodes dropped by release()
+#endif
+
+    static const size_t maxBlockSize = 65536;
+
+    void addBlock();
+
+public:
+
+    NodePool(size_t firstBlockSize=256): blocks(nullptr), freeList(nullptr), cursor(nullptr), blockEnd(nullptr), blockSize(firstBlockSize), live(0) {}
+    ~NodePool();
+
+    Node<T>* allocate(const T& element);
+    void deallocate(Node<T>* n);
+    void release(); //frees every block, lists using the pool must already be empty
+    size_t size() const;
+
+    //Nodes handed out and returned since construction or resetCounters, always 0 unless built with GRAPH_STATS
+    size_t allocated() const;
+    size_t freed() const;
+    void resetCounters();
+
+};
+
+template <class T>
+void NodePool<T>::addBlock()
+{
+    Block* b = new Block;
+    b->nodes = static_cast<Node<T>*>(::operator new(blockSize * sizeof(Node<T>)));
+    b->next = blocks;
+    blocks = b;
+
+    cursor = b->nodes;
+    blockEnd = b->nodes + blockSize;
+    if (blockSize < maxBlockSize)
+        blockSize *= 2;
+}
+
+template <class T>
+NodePool<T>::~NodePool()
+{
+    release();
+}
+
+template <class T>
+Node<T>* NodePool<T>::allocate(const T& element)
+{
+    Node<T>* n;
+    if (freeList != nullptr)
+    {
+        n = freeList;
+        freeList = freeList->next;
+    }
+    else
+    {
+        if (cursor == blockEnd)
+            addBlock();
+        n = cursor++;
+    }
+
+    live++;
+#ifdef GRAPH_STATS
+    allocations++;
+#endif
+    return new (n) Node<T>(element);
+}
+
+template <class T>
+void NodePool<T>::deallocate(Node<T>* n)
+{
+    n->~Node<T>();
+    n->next = freeList;
+    freeList = n;
+    live--;
+#ifdef GRAPH_STATS
+    deallocations++;
+#endif
+}
+
+template <class T>
+void NodePool<T>::release()
+{
+#ifdef GRAPH_STATS
+    deallocations += live;
+#endif
+    while (blocks != nullptr)
+    {
+        Block* next = blocks->next;
+        ::operator delete(blocks->nodes);
+        delete blocks;
+        blocks = next;
+    }
+
+    freeList = nullptr;
+    cursor = nullptr;
+    blockEnd = nullptr;
+    live = 0;
+}
+
+template <class T>
+size_t NodePool<T>::size() const
+{
+    return live;
+}
+
+template <class T>
+size_t NodePool<T>::allocated() const
+{
+#ifdef GRAPH_STATS
+    return allocations;
+#else
+    return 0;
+#endif
+}
+
+template <class T>
+size_t NodePool<T>::freed() const
+{
+#ifdef GRAPH_STATS
+    return deallocations;
+#else
+    return 0;
+#endif
+}
+
+template <class T>
+void NodePool<T>::resetCounters()
+{
+#ifdef GRAPH_STATS
+    allocations = 0;
+    deallocations = 0;
+#endif
+}
+
 template <class T>
 class LinkedList {
 
@@ -30,10 +189,14 @@ private:
     Node<T>* head;
     Node<T>* tail;
     size_t _size;
+    NodePool<T>* pool; //nullptr means plain new/delete
+
+    Node<T>* newNode(const T& element);
+    void freeNode(Node<T>* n);
 
 public:
 
-    LinkedList(): head(nullptr), tail(nullptr), _size(0) {}
+    LinkedList(NodePool<T>* pool=nullptr): head(nullptr), tail(nullptr), _size(0), pool(pool) {}
     ~LinkedList();
 
     //List iterator wrapper
@@ -76,6 +239,8 @@ public:
     void insert(size_t index, const T& element);
     void insert(ListIter& iter, const T& element);
     void erase(ListIter& position);
+    void clear();
+    void setPool(NodePool<T>* p); //only valid while the list is empty
     size_t size() const;
 
     T& operator[](size_t index);
@@ -87,11 +252,36 @@ public:
 
 };
 
+template <class T>
+Node<T>* LinkedList<T>::newNode(const T& element)
+{
+    if (pool != nullptr)
+        return pool->allocate(element);
+    return new Node<T>(element);
+}
+
+template <class T>
+void LinkedList<T>::freeNode(Node<T>* n)
+{
+    if (pool != nullptr)
+        pool->deallocate(n);
+    else
+        delete n;
+}
+
+template <class T>
+void LinkedList<T>::setPool(NodePool<T>* p)
+{
+    if (_size != 0)
+        throw std::logic_error("Cannot change the pool of a non-empty list");
+    pool = p;
+}
+
 template <class T>
 void LinkedList<T>::push_back(const T& element)
 {
 
-    Node<T>* elem = new Node<T>(element);
+    Node<T>* elem = newNode(element);
     if (_size == 0)
     {
         head = elem;
@@ -112,11 +302,15 @@ template <class T>
 void LinkedList<T>::pop_back()
 {
     if (_size == 1)
-        delete head;
+    {
+        freeNode(head);
+        head = nullptr;
+        tail = nullptr;
+    }
     else if (_size > 1)
     {
         Node<T>* temp = tail->previous;
-        delete tail;
+        freeNode(tail);
         tail = temp;
         tail->next = nullptr;
     }
@@ -133,7 +327,7 @@ void LinkedList<T>::insert(size_t index, const T& element)
     if (index > (_size - 1) && _size != 0)
         throw std::out_of_range("Index is out of range");
 
-    Node<T>* elem = new Node<T>(element);
+    Node<T>* elem = newNode(element);
     if (_size == 0) //special case - insert into empty list
     {
         head = elem;
@@ -167,7 +361,7 @@ void LinkedList<T>::insert(LinkedList<T>::ListIter& iter, const T& element)
     if (iter.iter == nullptr && _size != 0)
         throw std::out_of_range("Index is out of range");
 
-    Node<T>* elem = new Node<T>(element);
+    Node<T>* elem = newNode(element);
     if (_size == 0) //special case - insert into empty list
     {
         head = elem;
@@ -201,20 +395,27 @@ size_t LinkedList<T>::size() const
 template <class T>
 LinkedList<T>::~LinkedList()
 {
-    if (_size == 1)
-        delete head;
-    else if (_size > 1) //no action needed for _size == 0
-    {
-        Node<T>* iter = head;
-        while (iter != nullptr)
-        {
-            iter = head->next;
-            delete head;
-            head = iter;
-        }
+    //Pooled nodes of trivial types are reclaimed all at once with the pool, no need to walk them
+    if (pool != nullptr && std::is_trivially_destructible<T>::value)
+        return;
+    clear();
+}
 
+template <class T>
+void LinkedList<T>::clear()
+{
+    //Deletes every node and leaves the list empty
+    Node<T>* iter = head;
+    for (size_t i = 0; i < _size; i++)
+    {
+        Node<T>* next = iter->next;
+        freeNode(iter);
+        iter = next;
     }
-    
+
+    head = nullptr;
+    tail = nullptr;
+    _size = 0;
 }
 
 template <class T>
@@ -248,7 +449,7 @@ T& LinkedList<T>::operator[](size_t index)
 template <class T>
 void LinkedList<T>::push_front(const T& element)
 {
-    Node<T>* n = new Node<T>(element);
+    Node<T>* n = newNode(element);
     if (_size == 0)
     {
         head = n;
@@ -267,13 +468,17 @@ template <class T>
 void LinkedList<T>::pop_front()
 {
     if (_size == 1)
-        delete head;
+    {
+        freeNode(head);
+        head = nullptr;
+        tail = nullptr;
+    }
     else
     {
         Node<T>* temp = head;
         head = head->next;
         head->previous = nullptr;
-        delete temp;
+        freeNode(temp);
     }
     _size--;
 }
@@ -286,23 +491,25 @@ void LinkedList<T>::erase(LinkedList<T>::ListIter& position)
     {
         position.iter->next->previous = nullptr;
         head = position.iter->next;
-        delete position.iter;
+        freeNode(position.iter);
     }
     else if (position.iter == tail && _size > 1)
     {
         position.iter->previous->next = nullptr;
         tail = position.iter->previous;
-        delete position.iter;
+        freeNode(position.iter);
     }
     else if (_size == 1)
     {
-        delete position.iter;
+        freeNode(position.iter);
+        head = nullptr;
+        tail = nullptr;
     }
     else
     {
         position.iter->previous->next = position.iter->next;
         position.iter->next->previous = position.iter->previous;
-        delete position.iter;
+        freeNode(position.iter);
     }
     _size--;
 }
\ No newline at end of file
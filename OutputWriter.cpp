@@ -0,0 +1,302 @@
+#include "OutputWriter.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+static const size_t MAX_QUEUED = 64 << 20; //async writers block once this many bytes are waiting to be written
+static const size_t MAX_NUMBER = 32; //every number fits in 32 characters, so no block is smaller
+
+static bool writeAll(int fd, const char* data, size_t length)
+{
+    while (length > 0)
+    {
+        ssize_t n = ::write(fd, data, length);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += n;
+        length -= n;
+    }
+    return true;
+}
+
+//Single thread writing the blocks of every async writer in the order they were handed over
+class BackgroundWriter
+{
+
+private:
+
+    struct Job
+    {
+        int fd;
+        char* data; //owned by the job, null for a job that only closes the file
+        size_t length;
+        bool closeFile;
+        std::string filename;
+    };
+
+    std::thread thread;
+    std::mutex mtx;
+    std::condition_variable work;
+    std::condition_variable idle; //signalled whenever a job finishes
+    std::deque<Job> jobs;
+    size_t queued = 0; //bytes in jobs
+    bool busy = false; //a job has been taken off the queue and is being written
+    bool stopping = false;
+    std::string failed; //first file that could not be written since the last drain
+
+    void loop()
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (true)
+        {
+            work.wait(lock, [&] { return stopping || !jobs.empty(); });
+            if (jobs.empty())
+                return;
+
+            Job job = jobs.front();
+            jobs.pop_front();
+            busy = true;
+            lock.unlock();
+
+            bool ok = job.data == nullptr || writeAll(job.fd, job.data, job.length);
+            if (job.closeFile)
+                ok = ::close(job.fd) == 0 && ok;
+            delete[] job.data;
+
+            lock.lock();
+            if (!ok && failed.empty())
+                failed = job.filename;
+            queued -= job.length;
+            busy = false;
+            idle.notify_all();
+        }
+    }
+
+public:
+
+    ~BackgroundWriter()
+    {
+        //Runs at exit, so whatever is still queued reaches its file
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        work.notify_one();
+        if (thread.joinable())
+            thread.join();
+    }
+
+    void push(int fd, char* data, size_t length, bool closeFile, const std::string& filename)
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (!thread.joinable())
+            thread = std::thread(&BackgroundWriter::loop, this);
+
+        idle.wait(lock, [&] { return queued == 0 || queued + length <= MAX_QUEUED; });
+        jobs.push_back(Job{fd, data, length, closeFile, filename});
+        queued += length;
+        work.notify_one();
+    }
+
+    void drain()
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        idle.wait(lock, [&] { return jobs.empty() && !busy; });
+        if (!failed.empty())
+        {
+            std::string name = failed;
+            failed.clear();
+            throw std::runtime_error("Cannot write " + name);
+        }
+    }
+
+};
+
+static BackgroundWriter& background()
+{
+    static BackgroundWriter writer;
+    return writer;
+}
+
+OutputWriter::OutputWriter(std::string filename, bool async, size_t blockSize): blockSize(std::max(blockSize, MAX_NUMBER)), async(async), filename(filename)
+{
+    fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open " + filename);
+    if (async)
+        background(); //constructed before any writer hands it work, so it is destroyed after them at exit
+    block = new char[this->blockSize];
+}
+
+OutputWriter::OutputWriter(std::ostream& sink, size_t blockSize): blockSize(std::max(blockSize, MAX_NUMBER)), sink(&sink)
+{
+    block = new char[this->blockSize];
+}
+
+OutputWriter::~OutputWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+    delete[] block;
+}
+
+void OutputWriter::flushBlock(bool last)
+{
+    if (sink != nullptr)
+    {
+        sink->write(block, used);
+        if (last)
+            sink->flush();
+    }
+    else if (async)
+    {
+        //The block goes with the job and a fresh one takes its place
+        if (used > 0 || last)
+        {
+            background().push(fd, used > 0 ? block : nullptr, used, last, filename);
+            if (used > 0)
+                block = last ? nullptr : new char[blockSize];
+        }
+    }
+    else if (!writeAll(fd, block, used))
+    {
+        ::close(fd);
+        fd = -1;
+        used = 0;
+        throw std::runtime_error("Cannot write " + filename);
+    }
+    used = 0;
+}
+
+char* OutputWriter::reserve(size_t n)
+{
+    if (fd < 0 && sink == nullptr)
+        throw std::logic_error("OutputWriter used after close");
+    if (used + n > blockSize)
+        flushBlock(false);
+    return block + used;
+}
+
+void OutputWriter::write(const char* data, size_t length)
+{
+    if (length > blockSize)
+    {
+        //Too big to buffer, goes out in block sized pieces
+        for (size_t i = 0; i < length; i += blockSize)
+            write(data + i, std::min(blockSize, length - i));
+        return;
+    }
+    std::memcpy(reserve(length), data, length);
+    used += length;
+}
+
+template <typename T>
+static size_t formatNumber(char* out, T value)
+{
+    return std::to_chars(out, out + MAX_NUMBER, value).ptr - out;
+}
+
+OutputWriter& OutputWriter::operator<<(int value)
+{
+    used += formatNumber(reserve(MAX_NUMBER), value);
+    return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(unsigned value)
+{
+    used += formatNumber(reserve(MAX_NUMBER), value);
+    return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(long value)
+{
+    used += formatNumber(reserve(MAX_NUMBER), value);
+    return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(unsigned long value)
+{
+    used += formatNumber(reserve(MAX_NUMBER), value);
+    return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(long long value)
+{
+    used += formatNumber(reserve(MAX_NUMBER), value);
+    return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(unsigned long long value)
+{
+    used += formatNumber(reserve(MAX_NUMBER), value);
+    return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(double value)
+{
+    //6 significant digits, the same as a default std::ostream
+    char* out = reserve(MAX_NUMBER);
+    used += std::to_chars(out, out + MAX_NUMBER, value, std::chars_format::general, 6).ptr - out;
+    return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(char c)
+{
+    *reserve(1) = c;
+    used++;
+    return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(const char* s)
+{
+    write(s, std::strlen(s));
+    return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(const std::string& s)
+{
+    write(s.data(), s.size());
+    return *this;
+}
+
+void OutputWriter::close()
+{
+    if (sink != nullptr)
+    {
+        flushBlock(true);
+        sink = nullptr;
+        return;
+    }
+    if (fd < 0)
+        return;
+
+    flushBlock(true);
+    if (!async && ::close(fd) != 0)
+    {
+        fd = -1;
+        throw std::runtime_error("Cannot write " + filename);
+    }
+    fd = -1;
+}
+
+void OutputWriter::drain()
+{
+    background().drain();
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+//Buffered text writer for the result files
+//Numbers are formatted with std::to_chars straight into a large block, and nothing touches the file until a block fills up
+//or the writer is closed. In async mode full blocks are handed to one background thread shared by every async writer,
+//so the caller can go on with the next graph while the previous results are still being written
+
+class OutputWriter
+{
+
+private:
+
+    char* block;
+    size_t blockSize;
+    size_t used = 0;
+    int fd = -1; //file being written, -1 when writing to sink or once closed
+    std::ostream* sink = nullptr;
+    bool async = false;
+    std::string filename;
+
+    void flushBlock(bool last);
+    char* reserve(size_t n); //room for n more bytes, flushes the block first if needed
+
+public:
+
+    static const size_t DEFAULT_BLOCK = 1 << 20;
+
+    //Truncates or creates filename, throws std::runtime_error if it cannot be opened
+    //A blockSize below 32 bytes is raised to 32 so any single number fits in a block
+    OutputWriter(std::string filename, bool async=false, size_t blockSize=DEFAULT_BLOCK);
+    OutputWriter(std::ostream& sink, size_t blockSize=DEFAULT_BLOCK); //always synchronous
+    ~OutputWriter(); //closes, errors are only reported by an explicit close
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    OutputWriter& operator<<(int value);
+    OutputWriter& operator<<(unsigned value);
+    OutputWriter& operator<<(long value);
+    OutputWriter& operator<<(unsigned long value);
+    OutputWriter& operator<<(long long value);
+    OutputWriter& operator<<(unsigned long long value);
+    OutputWriter& operator<<(double value);
+    OutputWriter& operator<<(char c);
+    OutputWriter& operator<<(const char* s);
+    OutputWriter& operator<<(const std::string& s);
+    void write(const char* data, size_t length);
+
+    //Writes what is buffered and gives up the file. Synchronous writers throw std::runtime_error if a write failed,
+    //async writers return at once and their errors surface in the next drain()
+    void close();
+
+    //Waits until every async writer has reached its file, throws std::runtime_error naming the first file that failed since the last drain
+    static void drain();
+
+};
@@ -0,0 +1,126 @@
+#include "PairSet.h"
+
+PairSet::PairSet(size_t expected): count(0)
+{
+    capacity = 16;
+    while (capacity < expected * 2)
+        capacity *= 2;
+
+    slots = new uint64_t[capacity];
+    for (size_t i = 0; i < capacity; i++)
+        slots[i] = EMPTY;
+}
+
+PairSet::~PairSet()
+{
+    delete[] slots;
+}
+
+uint64_t PairSet::pack(int a, int b)
+{
+    return ((uint64_t)(uint32_t)a << 32) | (uint32_t)b;
+}
+
+uint64_t PairSet::hash(uint64_t key)
+{
+    //splitmix64 finalizer, spreads consecutive ids across the table
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return key;
+}
+
+void PairSet::grow()
+{
+    //Doubles the table and reinserts every key
+    uint64_t* old = slots;
+    size_t oldCapacity = capacity;
+
+    capacity *= 2;
+    slots = new uint64_t[capacity];
+    for (size_t i = 0; i < capacity; i++)
+        slots[i] = EMPTY;
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < oldCapacity; i++)
+    {
+        if (old[i] == EMPTY)
+            continue;
+        size_t pos = hash(old[i]) & mask;
+        while (slots[pos] != EMPTY)
+            pos = (pos + 1) & mask;
+        slots[pos] = old[i];
+    }
+
+    delete[] old;
+}
+
+bool PairSet::insert(int a, int b)
+{
+    if ((count + 1) * 2 > capacity)
+        grow();
+
+    uint64_t key = pack(a, b);
+    size_t mask = capacity - 1;
+    size_t pos = hash(key) & mask;
+    while (slots[pos] != EMPTY)
+    {
+        if (slots[pos] == key)
+            return false;
+        pos = (pos + 1) & mask;
+    }
+
+    slots[pos] = key;
+    count++;
+    return true;
+}
+
+bool PairSet::erase(int a, int b)
+{
+    uint64_t key = pack(a, b);
+    size_t mask = capacity - 1;
+    size_t pos = hash(key) & mask;
+    while (slots[pos] != key)
+    {
+        if (slots[pos] == EMPTY)
+            return false;
+        pos = (pos + 1) & mask;
+    }
+
+    //Move later keys of the run into the hole unless that would put them before their home slot
+    size_t hole = pos;
+    for (size_t next = (hole + 1) & mask; slots[next] != EMPTY; next = (next + 1) & mask)
+    {
+        size_t home = hash(slots[next]) & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            slots[hole] = slots[next];
+            hole = next;
+        }
+    }
+
+    slots[hole] = EMPTY;
+    count--;
+    return true;
+}
+
+bool PairSet::contains(int a, int b) const
+{
+    uint64_t key = pack(a, b);
+    size_t mask = capacity - 1;
+    size_t pos = hash(key) & mask;
+    while (slots[pos] != EMPTY)
+    {
+        if (slots[pos] == key)
+            return true;
+        pos = (pos + 1) & mask;
+    }
+    return false;
+}
+
+size_t PairSet::size() const
+{
+    return count;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+//Open addressing hash set of (int, int) pairs packed into one 64 bit key
+//Uses linear probing and keeps the load factor at or below 1/2
+//Erasing shifts the rest of the probe run back instead of leaving tombstones, so lookups never slow down after deletes
+
+class PairSet
+{
+
+private:
+
+    static const uint64_t EMPTY = ~0ULL; //no valid pair packs to this value
+
+    uint64_t* slots;
+    size_t capacity; //always a power of two
+    size_t count;
+
+    static uint64_t hash(uint64_t key);
+    void grow();
+
+public:
+
+    PairSet(size_t expected=16);
+    ~PairSet();
+
+    static uint64_t pack(int a, int b);
+
+    bool insert(int a, int b); //returns false if the pair was already present
+    bool erase(int a, int b); //returns false if the pair was not present
+    bool contains(int a, int b) const;
+    size_t size() const;
+
+};
@@ -1,73 +1,131 @@
 #include "RandomGen.h"
 
-RandomGen::~RandomGen()
+double RandomGen::randRealUniform()
 {
-    delete[] ranges;
+    return rng.nextDouble();
 }
 
-double RandomGen::randRealUniform()
+int RandomGen::skewedFromUniform(double r, int max)
 {
-    return uniformReal(generator);
+    //Linearly decreasing distribution, P(k) is proportional to max - k for k in [0, max)
+    //Writing j = max - k, P(j) is proportional to j for j in [1, max] with CDF j(j + 1) / (max(max + 1)),
+    //so the inverse CDF is the smallest j with j(j + 1) > r * max(max + 1), found in closed form
+    double t = r * max * (max + 1.0);
+    double j = floor((sqrt(1 + 4 * t) - 1) / 2) + 1;
+
+    //Correct the rounding of the square root, then keep j in range
+    j -= ((j - 1) * j > t) ? 1 : 0;
+    j += (j * (j + 1) <= t) ? 1 : 0;
+    j = std::min(std::max(j, 1.0), (double)max);
+
+    return max - (int)j;
 }
 
 int RandomGen::randSkewed()
 {
-    double s = (max*(max + 1)) / 2;
-    double r = randRealUniform();
-    int result;
-    
-    for (int i = 1; i < max + 1; i++)
+    if (max <= 0)
+        return 0;
+    return skewedFromUniform(randRealUniform(), max);
+}
+
+void RandomGen::fillSkewed(int* out, size_t count)
+{
+    if (max <= 0)
     {
-        if (r >= ranges[i-1] && r < ranges[i])
-        {
-            result = i - 1;
-            break;
-        }
+        std::fill(out, out + count, 0);
+        return;
     }
 
-    return result;
-
+    //The generator is sequential, so the uniform draws are made first and transformed in a separate loop
+    const size_t block = 256;
+    double r[block];
+    for (size_t start = 0; start < count; start += block)
+    {
+        size_t n = std::min(block, count - start);
+        for (size_t i = 0; i < n; i++)
+            r[i] = randRealUniform();
+        for (size_t i = 0; i < n; i++)
+            out[start + i] = skewedFromUniform(r[i], max);
+    }
 }
 
 int RandomGen::randUniform()
 {
-    return uniform(generator);
+    return rng.bounded((uint32_t)max + 1);
 }
 
-int RandomGen::randNormalInRange()
-{
-    //Uses Box-Mueller transform to generate normal distribution
-    //Box-Mueller generates two values, one is stored for later use and one is returned immediately
-    //Inspired by code from here: https://statisticsblog412536603.wordpress.com/2019/10/31/do-research-about-box-muller-transform/
+//Inverse of the standard normal CDF (Acklam's rational approximation, relative error below 1.2e-9)
+//Only the central branch is taken for |z| < 1.97, which covers the whole truncated range once max >= 4
 
-    //This output could be outside the specifed range, so randNormal() resamples until it gets a suitable value
+static double invNormalCdf(double p)
+{
+    static const double a[6] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[5] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[6] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[4] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                3.754408661907416e+00};
+    const double pLow = 0.02425;
 
-    double result = -1.0;
-    if (z1_stored == -1)
-    {
-        double u1 = randRealUniform();
-        double u2 = randRealUniform();
-        double z0 = sqrt(-2 * log(u1)) * cos(2*M_PI*u2);
-        double z1 = sqrt(-2 * log(u1)) * sin(2*M_PI*u2);
-        z1_stored = z1;
-        if (z0 >= 0 && z0 <= max) //make sure its in the correct range
-            result = z0;
-    }
-    else
+    if (p >= pLow && p <= 1 - pLow)
     {
-        result = z1_stored;
-        z1_stored = -1;
+        double q = p - 0.5;
+        double r = q * q;
+        return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q
+             / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
     }
 
-    return result * (max / 3) + (max / 2); //normal with mean of max/2 and sigma max/3
+    double q = sqrt(-2 * log(p < pLow ? p : 1 - p));
+    double x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5])
+             / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    return p < pLow ? x : -x;
+}
+
+void RandomGen::initNormal()
+{
+    //randNormal rounds max / 2 + z * max / 3 to the nearest integer, which lands in [0, max] exactly when |z| < bound,
+    //so the standard normal is truncated to [-bound, bound) by drawing its CDF uniformly from that interval
+    if (max <= 0)
+        return;
+    double bound = 1.5 * (max + 1.0) / max;
+    normalLow = 0.5 * erfc(bound / sqrt(2.0));
+    normalSpan = 1 - 2 * normalLow;
+}
+
+int RandomGen::normalFromUniform(double r) const
+{
+    //Maps a uniform draw in [0, 1) to the truncated normal, the clamp only catches rounding at the ends
+    double z = invNormalCdf(normalLow + r * normalSpan);
+    double x = floor(max / 2.0 + z * (max / 3.0) + 0.5);
+    return (int)std::min(std::max(x, 0.0), (double)max);
 }
 
 int RandomGen::randNormal()
 {
-    int result = -1;
-    while (result < 0 || result > max)
-        result = randNormalInRange();
+    if (max <= 0)
+        return 0;
+    return normalFromUniform(randRealUniform());
+}
 
-    return result;
+void RandomGen::fillNormal(int* out, size_t count)
+{
+    if (max <= 0)
+    {
+        std::fill(out, out + count, 0);
+        return;
+    }
 
-}
\ No newline at end of file
+    //As in fillSkewed, the uniform draws are made first and transformed in a separate loop
+    const size_t block = 256;
+    double r[block];
+    for (size_t start = 0; start < count; start += block)
+    {
+        size_t n = std::min(block, count - start);
+        for (size_t i = 0; i < n; i++)
+            r[i] = randRealUniform();
+        for (size_t i = 0; i < n; i++)
+            out[start + i] = normalFromUniform(r[i]);
+    }
+}
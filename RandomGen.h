@@ -1,5 +1,7 @@
 #pragma once
-#include <random>
+#include "Rng.h"
+#include <algorithm>
+#include <cstdint>
 #include <math.h>
 //#include <math.h>
 
@@ -11,34 +13,35 @@ class RandomGen
 private:
 
     int max;
-    std::mt19937 generator;
-    std::uniform_int_distribution<int> uniform;
-    std::uniform_real_distribution<double> uniformReal;
+    Rng rng;
+    double normalLow = 0; //standard normal CDF at the lower end of the range randNormal keeps
+    double normalSpan = 1; //CDF mass of that range
 
-    double z1_stored = -1;
-    double* ranges;
-
-    double randRealUniform();
-    int randNormalInRange();
+    void initNormal();
+    int normalFromUniform(double r) const;
+    static int skewedFromUniform(double r, int max);
 
 public:
 
-    RandomGen(int max): generator(time(NULL)), uniform(0, max), uniformReal(0.0, 1.0), max(max)
+    RandomGen(int max): max(max), rng()
+    {
+        initNormal();
+    }
+
+    //Reproducible generator drawing from the given stream, pass rng.split() to leave the caller's stream untouched
+    RandomGen(int max, const Rng& rng): max(max), rng(rng)
     {
-        //Create ranges array for probability ranges of skewed distribution
-        ranges = new double[max + 1];
-        ranges[0] = 0;
-        ranges[max + 1] = 1;
-
-        double s = (max*(max + 1)) / 2;
-        for (int i = 1; i < max + 1; i++)
-            ranges[i] = ranges[i-1] + ((max - i + 1) / s);
+        initNormal();
     }
-    ~RandomGen();
 
+    double randRealUniform(); //in [0, 1)
     int randUniform();
     int randSkewed();
+    void fillSkewed(int* out, size_t count); //count randSkewed() values, with the transform done in a vectorizable loop
+    //Mean max / 2, standard deviation max / 3, truncated to [0, max]. Sampled by inverse CDF over the kept range,
+    //so every draw lands in range and none is rejected
     int randNormal();
+    void fillNormal(int* out, size_t count); //count randNormal() values, with the transform done in a separate loop
 
 };
     
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "Rng.h"
+#include <random>
+
+Rng::Rng()
+{
+    std::random_device rd;
+    seed(((uint64_t)rd() << 32) | rd());
+}
+
+Rng::Rng(uint64_t seed)
+{
+    this->seed(seed);
+}
+
+void Rng::seed(uint64_t seed)
+{
+    //Expands the seed with splitmix64, which never gives the all zero state
+    for (int i = 0; i < 4; i++)
+    {
+        seed += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        s[i] = z ^ (z >> 31);
+    }
+}
+
+void Rng::jump()
+{
+    static const uint64_t JUMP[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+
+    uint64_t t[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            if (JUMP[i] & (1ULL << b))
+            {
+                t[0] ^= s[0];
+                t[1] ^= s[1];
+                t[2] ^= s[2];
+                t[3] ^= s[3];
+            }
+            next();
+        }
+    }
+
+    for (int i = 0; i < 4; i++)
+        s[i] = t[i];
+}
+
+Rng Rng::split()
+{
+    Rng child = *this;
+    jump();
+    return child;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+//xoshiro256** generator (Blackman and Vigna), 32 bytes of state and a period of 2^256 - 1
+//jump() advances the state by 2^128 draws, so split() hands out non-overlapping streams for threads
+//Also meets UniformRandomBitGenerator, so it can drive the <random> distributions and std::shuffle
+
+class Rng
+{
+
+private:
+
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+
+    typedef uint64_t result_type;
+
+    Rng(); //seeded from std::random_device
+    explicit Rng(uint64_t seed);
+
+    void seed(uint64_t seed);
+    void jump();
+    Rng split(); //returns a generator for the current stream and moves this one to the next
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return ~0ULL; }
+    uint64_t operator()() { return next(); }
+
+    //The draws are inline since they sit in the inner loops of the generators and orderings
+    uint64_t next()
+    {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    //Uniform in [0, 1) with 53 random bits
+    double nextDouble()
+    {
+        return (next() >> 11) * 0x1.0p-53;
+    }
+
+    //Uniform in [0, range) without division in the common case (Lemire, 2019), range must be > 0
+    uint32_t bounded(uint32_t range)
+    {
+        uint64_t m = (next() >> 32) * range;
+        uint32_t low = (uint32_t)m;
+        if (low < range)
+        {
+            uint32_t threshold = -range % range;
+            while (low < threshold)
+            {
+                m = (next() >> 32) * range;
+                low = (uint32_t)m;
+            }
+        }
+        return m >> 32;
+    }
+
+};
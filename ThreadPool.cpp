@@ -0,0 +1,92 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t numThreads)
+{
+    if (numThreads == 0)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (size_t i = 1; i < numThreads; i++)
+        threads.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    start.notify_all();
+    for (auto& t : threads)
+        t.join();
+}
+
+size_t ThreadPool::size() const
+{
+    return threads.size() + 1;
+}
+
+void ThreadPool::workerLoop(size_t worker)
+{
+    size_t seen = 0;
+    while (true)
+    {
+        const std::function<void(size_t)>* fn;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            start.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+            fn = job;
+        }
+
+        (*fn)(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            running--;
+        }
+        done.notify_one();
+    }
+}
+
+void ThreadPool::run(const std::function<void(size_t worker)>& fn)
+{
+    if (threads.empty())
+    {
+        fn(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        job = &fn;
+        running = threads.size();
+        generation++;
+    }
+    start.notify_all();
+
+    fn(0);
+
+    std::unique_lock<std::mutex> lock(mtx);
+    done.wait(lock, [&] { return running == 0; });
+    job = nullptr;
+}
+
+void ThreadPool::parallelFor(size_t n, size_t grain, const std::function<void(size_t begin, size_t end, size_t worker)>& fn)
+{
+    if (grain == 0)
+        grain = 1;
+
+    std::atomic<size_t> next(0);
+    run([&](size_t worker) {
+        while (true)
+        {
+            size_t begin = next.fetch_add(grain);
+            if (begin >= n)
+                return;
+            fn(begin, std::min(begin + grain, n), worker);
+        }
+    });
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Fixed set of worker threads that run one job at a time
+//The calling thread takes part as worker 0, so a pool of size 1 runs everything inline
+
+class ThreadPool
+{
+
+private:
+
+    std::vector<std::thread> threads;
+    std::mutex mtx;
+    std::condition_variable start;
+    std::condition_variable done;
+    const std::function<void(size_t)>* job = nullptr;
+    size_t generation = 0; //bumped for every job so sleeping workers know to wake up
+    size_t running = 0; //background workers still inside the current job
+    bool stopping = false;
+
+    void workerLoop(size_t worker);
+
+public:
+
+    ThreadPool(size_t numThreads=0); //0 uses every hardware thread
+    ~ThreadPool();
+
+    size_t size() const;
+
+    //Runs fn(worker) once on every worker and returns when all of them have finished
+    void run(const std::function<void(size_t worker)>& fn);
+
+    //Splits [0, n) into chunks of grain items handed out on demand, fn(begin, end, worker) runs once per chunk
+    void parallelFor(size_t n, size_t grain, const std::function<void(size_t begin, size_t end, size_t worker)>& fn);
+
+};
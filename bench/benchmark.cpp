@@ -0,0 +1,515 @@
+//Benchmark driver for graph construction, coloring and graph file I/O
+//
+//Build from the repository root:
+//  g++ -std=c++17 -O2 -pthread -I. bench/benchmark.cpp $(ls *.cpp | grep -v '^main.cpp$') -o benchmark
+//
+//Example, the old graphCreation() experiment:
+//  ./benchmark --family cycle,complete,uniform,skewed,normal --sizes 100:3000:100 --algos none --reps 3 --save-dir graphs
+//
+//Every (family, size, algorithm) case runs the warmup runs, then the timed repetitions on a freshly built graph.
+//Each phase is reported as min, median, p95 and mean in milliseconds, in CSV and JSON along with machine and commit metadata
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "AdjacencyList.h"
+
+using namespace std;
+
+struct Options
+{
+    vector<string> families = {"uniform"};
+    vector<string> graphFiles;
+    vector<size_t> sizes = {1000, 2000, 3000, 4000, 5000};
+    double density = 0.05; //fraction of the possible edges in the random families
+    vector<string> algorithms = {"slvo", "sodl", "random", "llvo", "lodl", "inorder"};
+    int warmup = 1;
+    int reps = 5;
+    uint64_t seed = 1;
+    size_t threads = 0;
+    bool io = false;
+    bool report = false;
+    string csvFile = "results/benchmark.csv";
+    string jsonFile = "results/benchmark.json";
+    string saveDir;
+};
+
+//One timed phase of one case, samples are in seconds
+struct Result
+{
+    string family;
+    size_t vertices = 0;
+    size_t edges = 0;
+    string algorithm;
+    string phase;
+    vector<double> samples;
+    int colors = 0;
+};
+
+static void usage()
+{
+    cerr << "usage: benchmark [options]\n"
+         << "  --family LIST     cycle, complete, uniform, skewed, normal (default uniform)\n"
+         << "  --graph FILE      benchmark a .graph file, may be repeated\n"
+         << "  --sizes LIST      comma separated vertex counts or a range FROM:TO:STEP (default 1000:5000:1000)\n"
+         << "  --density D       fraction of possible edges for the random families (default 0.05)\n"
+         << "  --algos LIST      slvo, sodl, random, llvo, lodl, inorder, jp, jpldf, dsatur, rlf, spec-<one of the first six>, or none\n"
+         << "  --warmup N        untimed runs before each case (default 1)\n"
+         << "  --reps N          timed runs per case (default 5)\n"
+         << "  --seed S          seed for the random graphs and orderings (default 1)\n"
+         << "  --threads N       threads for the parallel algorithms, 0 uses every hardware thread\n"
+         << "  --io              also time saving and loading the text and binary formats\n"
+         << "  --report          format the per-vertex coloring report (to /dev/null) as part of the output phase\n"
+         << "  --save-dir DIR    save the graph of every case as DIR/<family>_<vertices>.graph\n"
+         << "  --csv FILE        CSV output (default results/benchmark.csv)\n"
+         << "  --json FILE       JSON output (default results/benchmark.json)\n";
+}
+
+static vector<string> splitList(const string& s)
+{
+    vector<string> items;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty())
+            items.push_back(item);
+    return items;
+}
+
+static vector<size_t> parseSizes(const string& s)
+{
+    vector<size_t> sizes;
+    if (s.find(':') != string::npos)
+    {
+        size_t from = 0, to = 0, step = 0;
+        if (sscanf(s.c_str(), "%zu:%zu:%zu", &from, &to, &step) != 3 || step == 0)
+            throw invalid_argument("bad size range " + s);
+        for (size_t n = from; n <= to; n += step)
+            sizes.push_back(n);
+    }
+    else
+    {
+        for (const string& item : splitList(s))
+            sizes.push_back(stoull(item));
+    }
+    return sizes;
+}
+
+static Options parseArgs(int argc, char** argv)
+{
+    Options opt;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--help" || arg == "-h")
+        {
+            usage();
+            exit(0);
+        }
+        if (i + 1 >= argc)
+        {
+            cerr << "missing value for " << arg << endl;
+            usage();
+            exit(1);
+        }
+
+        string value = argv[++i];
+        if (arg == "--family")
+            opt.families = splitList(value);
+        else if (arg == "--graph")
+            opt.graphFiles.push_back(value);
+        else if (arg == "--sizes")
+            opt.sizes = parseSizes(value);
+        else if (arg == "--density")
+            opt.density = stod(value);
+        else if (arg == "--algos")
+            opt.algorithms = value == "none" ? vector<string>() : splitList(value);
+        else if (arg == "--warmup")
+            opt.warmup = stoi(value);
+        else if (arg == "--reps")
+            opt.reps = stoi(value);
+        else if (arg == "--seed")
+            opt.seed = stoull(value);
+        else if (arg == "--threads")
+            opt.threads = stoull(value);
+        else if (arg == "--csv")
+            opt.csvFile = value;
+        else if (arg == "--json")
+            opt.jsonFile = value;
+        else if (arg == "--save-dir")
+            opt.saveDir = value;
+        else if (arg == "--io" || arg == "--report")
+        {
+            (arg == "--io" ? opt.io : opt.report) = true;
+            i--; //takes no value
+        }
+        else
+        {
+            cerr << "unknown option " << arg << endl;
+            usage();
+            exit(1);
+        }
+    }
+
+    //--graph on its own benchmarks just the files
+    bool familyGiven = false;
+    for (int i = 1; i < argc; i++)
+        if (string(argv[i]) == "--family")
+            familyGiven = true;
+    if (!opt.graphFiles.empty() && !familyGiven)
+        opt.families.clear();
+
+    if (opt.reps < 1)
+        throw invalid_argument("--reps must be at least 1");
+    return opt;
+}
+
+//An algorithm name is a plain ordering, DSatur, RLF, a Jones-Plassmann variant, or spec-<ordering> for the speculative engine
+//where the ordering is one of slvo, sodl, random, llvo, lodl and inorder
+static AdjacencyList::Coloring parseColoring(const string& name)
+{
+    static const map<string, AdjacencyList::Coloring> names = {
+        {"slvo", AdjacencyList::Coloring::SLVO},
+        {"sodl", AdjacencyList::Coloring::SODL},
+        {"random", AdjacencyList::Coloring::RANDOM},
+        {"llvo", AdjacencyList::Coloring::LLVO},
+        {"lodl", AdjacencyList::Coloring::LODL},
+        {"inorder", AdjacencyList::Coloring::IN_ORDER},
+        {"jp", AdjacencyList::Coloring::JONES_PLASSMANN},
+        {"jpldf", AdjacencyList::Coloring::JONES_PLASSMANN_LDF},
+        {"dsatur", AdjacencyList::Coloring::DSATUR},
+        {"rlf", AdjacencyList::Coloring::RLF}
+    };
+
+    bool speculative = name.compare(0, 5, "spec-") == 0;
+    string base = speculative ? name.substr(5) : name;
+    auto it = names.find(base);
+    if (it == names.end())
+        throw invalid_argument("unknown algorithm " + name);
+
+    //The speculative engine colors in the order of a plain ordering, the other algorithms have none
+    AdjacencyList::Coloring c = it->second;
+    if (speculative && (c == AdjacencyList::Coloring::JONES_PLASSMANN || c == AdjacencyList::Coloring::JONES_PLASSMANN_LDF
+        || c == AdjacencyList::Coloring::DSATUR || c == AdjacencyList::Coloring::RLF))
+        throw invalid_argument(name + " needs a vertex ordering, " + base + " has none");
+    return c;
+}
+
+static AdjacencyList buildGraph(const string& family, size_t n, const Options& opt)
+{
+    //Random families restart from the same seed so every repetition times the same graph
+    Rng rng(opt.seed);
+    size_t numEdges = opt.density * (n * (n - 1) / 2);
+    if (family == "cycle")
+        return AdjacencyList::createCycle(n);
+    if (family == "complete")
+        return AdjacencyList::createCompleteGraph(n);
+    if (family == "uniform")
+        return AdjacencyList::createRandomGraph(n, numEdges, AdjacencyList::Distribution::UNIFORM, rng, opt.threads);
+    if (family == "skewed")
+        return AdjacencyList::createRandomGraph(n, numEdges, AdjacencyList::Distribution::SKEWED, rng, opt.threads);
+    if (family == "normal")
+        return AdjacencyList::createRandomGraph(n, numEdges, AdjacencyList::Distribution::NORMAL, rng, opt.threads);
+    throw invalid_argument("unknown graph family " + family);
+}
+
+static double seconds(chrono::steady_clock::time_point a, chrono::steady_clock::time_point b)
+{
+    return chrono::duration<double>(b - a).count();
+}
+
+static double percentile(vector<double> samples, double p)
+{
+    //Nearest rank percentile
+    sort(samples.begin(), samples.end());
+    size_t rank = (size_t)ceil(p * samples.size());
+    return samples[rank == 0 ? 0 : rank - 1];
+}
+
+static double mean(const vector<double>& samples)
+{
+    double total = 0;
+    for (double s : samples)
+        total += s;
+    return total / samples.size();
+}
+
+static string runCommand(const string& cmd)
+{
+    string out;
+    FILE* p = popen(cmd.c_str(), "r");
+    if (p == nullptr)
+        return out;
+    char buf[256];
+    while (fgets(buf, sizeof(buf), p) != nullptr)
+        out += buf;
+    pclose(p);
+    while (!out.empty() && (out.back() == '\n' || out.back() == '\r'))
+        out.pop_back();
+    return out;
+}
+
+static string jsonEscape(const string& s)
+{
+    string out;
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        if ((unsigned char)c < 0x20)
+            continue;
+        out += c;
+    }
+    return out;
+}
+
+static vector<pair<string, string>> metadata(const Options& opt)
+{
+    vector<pair<string, string>> meta;
+
+    char stamp[32];
+    time_t now = time(nullptr);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+    meta.push_back({"timestamp", stamp});
+
+    char host[256] = "";
+    gethostname(host, sizeof(host) - 1);
+    meta.push_back({"host", host});
+
+    string cpu = runCommand("grep -m1 'model name' /proc/cpuinfo | cut -d: -f2- | sed 's/^ *//'");
+    meta.push_back({"cpu", cpu.empty() ? "unknown" : cpu});
+    meta.push_back({"hardware_threads", to_string(thread::hardware_concurrency())});
+    meta.push_back({"threads", to_string(opt.threads)});
+
+    string commit = runCommand("git rev-parse HEAD 2>/dev/null");
+    meta.push_back({"commit", commit.empty() ? "unknown" : commit});
+    if (!commit.empty())
+        meta.push_back({"dirty", runCommand("git status --porcelain --untracked-files=no 2>/dev/null").empty() ? "false" : "true"});
+
+#ifdef __VERSION__
+    meta.push_back({"compiler", __VERSION__});
+#endif
+#ifdef __OPTIMIZE__
+    meta.push_back({"optimized", "true"});
+#else
+    meta.push_back({"optimized", "false"});
+#endif
+
+    meta.push_back({"warmup", to_string(opt.warmup)});
+    meta.push_back({"reps", to_string(opt.reps)});
+    meta.push_back({"seed", to_string(opt.seed)});
+    meta.push_back({"density", to_string(opt.density)});
+    return meta;
+}
+
+static void writeCsv(const string& filename, const vector<Result>& results, const vector<pair<string, string>>& meta)
+{
+    ofstream file(filename);
+    if (!file)
+    {
+        cerr << "cannot write " << filename << endl;
+        return;
+    }
+
+    //Metadata goes in leading comment lines so the table stays plain CSV
+    for (auto& m : meta)
+        file << "# " << m.first << ": " << m.second << "\n";
+
+    file << "family,vertices,edges,algorithm,phase,reps,min_ms,median_ms,p95_ms,mean_ms,colors\n";
+    for (const Result& r : results)
+    {
+        file << r.family << "," << r.vertices << "," << r.edges << "," << r.algorithm << "," << r.phase << ","
+             << r.samples.size() << "," << percentile(r.samples, 0) * 1e3 << "," << percentile(r.samples, 0.5) * 1e3 << ","
+             << percentile(r.samples, 0.95) * 1e3 << "," << mean(r.samples) * 1e3 << "," << r.colors << "\n";
+    }
+}
+
+static void writeJson(const string& filename, const vector<Result>& results, const vector<pair<string, string>>& meta)
+{
+    ofstream file(filename);
+    if (!file)
+    {
+        cerr << "cannot write " << filename << endl;
+        return;
+    }
+
+    file << "{\n  \"metadata\": {";
+    for (size_t i = 0; i < meta.size(); i++)
+        file << (i ? "," : "") << "\n    \"" << meta[i].first << "\": \"" << jsonEscape(meta[i].second) << "\"";
+    file << "\n  },\n  \"results\": [";
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result& r = results[i];
+        file << (i ? "," : "") << "\n    {\"family\": \"" << jsonEscape(r.family) << "\", \"vertices\": " << r.vertices
+             << ", \"edges\": " << r.edges << ", \"algorithm\": \"" << r.algorithm << "\", \"phase\": \"" << r.phase
+             << "\", \"colors\": " << r.colors << ", \"min_ms\": " << percentile(r.samples, 0) * 1e3
+             << ", \"median_ms\": " << percentile(r.samples, 0.5) * 1e3 << ", \"p95_ms\": " << percentile(r.samples, 0.95) * 1e3
+             << ", \"mean_ms\": " << mean(r.samples) * 1e3 << ", \"samples_ms\": [";
+        for (size_t s = 0; s < r.samples.size(); s++)
+            file << (s ? ", " : "") << r.samples[s] * 1e3;
+        file << "]}";
+    }
+    file << "\n  ]\n}\n";
+}
+
+//Runs one family and size, build is called once per run and returns a fresh graph
+template <typename Build>
+static void runCase(const string& family, Build build, const Options& opt, vector<Result>& results)
+{
+    Result construction;
+    construction.family = family;
+    construction.algorithm = "-";
+    construction.phase = "construction";
+
+    //Builds a fresh graph, records the construction time if asked and hands the graph to use
+    auto withGraph = [&](bool record, auto use) {
+        auto start = chrono::steady_clock::now();
+        AdjacencyList g = build();
+        auto stop = chrono::steady_clock::now();
+        if (record)
+            construction.samples.push_back(seconds(start, stop));
+        use(g);
+    };
+
+    //Used for the edge count, --save-dir and --io
+    AdjacencyList sample = build();
+    construction.vertices = sample.V();
+    construction.edges = sample.E();
+    cerr << family << " V=" << construction.vertices << " E=" << construction.edges << endl;
+
+    if (!opt.saveDir.empty())
+        sample.save(opt.saveDir + "/" + family + "_" + to_string(construction.vertices) + ".graph");
+
+    if (opt.algorithms.empty())
+    {
+        for (int run = 0; run < opt.warmup + opt.reps; run++)
+            withGraph(run >= opt.warmup, [](AdjacencyList&) {});
+    }
+
+    for (const string& name : opt.algorithms)
+    {
+        AdjacencyList::Coloring algorithm = parseColoring(name);
+        bool speculative = name.compare(0, 5, "spec-") == 0;
+        const char* phases[] = {"ordering", "coloring", "output"};
+        ofstream null("/dev/null");
+        Result phase[3];
+        for (int p = 0; p < 3; p++)
+        {
+            phase[p].family = family;
+            phase[p].vertices = construction.vertices;
+            phase[p].edges = construction.edges;
+            phase[p].algorithm = name;
+            phase[p].phase = phases[p];
+        }
+
+        for (int run = 0; run < opt.warmup + opt.reps; run++)
+        {
+            bool record = run >= opt.warmup;
+            withGraph(record, [&](AdjacencyList& g) {
+                g.setNumThreads(opt.threads);
+                g.setSeed(opt.seed);
+                if (opt.report)
+                    g.setReport(&null);
+                AdjacencyList::ColoringResult result = speculative ? g.colorGraphSpeculative(algorithm) : g.colorGraph(algorithm);
+
+                if (!record)
+                    return;
+                const AdjacencyList::PhaseTimes& t = g.lastPhaseTimes();
+                phase[0].samples.push_back(t.ordering);
+                phase[1].samples.push_back(t.coloring);
+                phase[2].samples.push_back(t.output);
+                for (int p = 0; p < 3; p++)
+                    phase[p].colors = result.numColors;
+            });
+        }
+
+        cerr << "  " << name << ": " << phase[1].colors << " colors, median coloring "
+             << percentile(phase[1].samples, 0.5) * 1e3 << " ms" << endl;
+        for (int p = 0; p < 3; p++)
+            results.push_back(phase[p]);
+    }
+    results.push_back(construction);
+
+    if (opt.io)
+    {
+        string textFile = "/tmp/benchmark_" + to_string(getpid()) + ".graph";
+        string binaryFile = "/tmp/benchmark_" + to_string(getpid()) + ".bgraph";
+        const char* phases[] = {"save_text", "load_text", "save_binary", "load_binary"};
+        Result io[4];
+        for (int p = 0; p < 4; p++)
+        {
+            io[p].family = family;
+            io[p].vertices = construction.vertices;
+            io[p].edges = construction.edges;
+            io[p].algorithm = "-";
+            io[p].phase = phases[p];
+        }
+
+        for (int run = 0; run < opt.warmup + opt.reps; run++)
+        {
+            auto t0 = chrono::steady_clock::now();
+            sample.save(textFile);
+            auto t1 = chrono::steady_clock::now();
+            AdjacencyList text(textFile, false, opt.threads);
+            auto t2 = chrono::steady_clock::now();
+            sample.saveBinary(binaryFile);
+            auto t3 = chrono::steady_clock::now();
+            AdjacencyList binary = AdjacencyList::loadBinary(binaryFile);
+            auto t4 = chrono::steady_clock::now();
+
+            if (run < opt.warmup)
+                continue;
+            io[0].samples.push_back(seconds(t0, t1));
+            io[1].samples.push_back(seconds(t1, t2));
+            io[2].samples.push_back(seconds(t2, t3));
+            io[3].samples.push_back(seconds(t3, t4));
+        }
+        remove(textFile.c_str());
+        remove(binaryFile.c_str());
+
+        for (int p = 0; p < 4; p++)
+            results.push_back(io[p]);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    vector<Result> results;
+    try
+    {
+        Options opt = parseArgs(argc, argv);
+        for (const string& name : opt.algorithms)
+            parseColoring(name); //fail before running anything
+
+        for (const string& family : opt.families)
+            for (size_t n : opt.sizes)
+                runCase(family, [&]() { return buildGraph(family, n, opt); }, opt, results);
+
+        for (const string& file : opt.graphFiles)
+            runCase(file, [&]() { return AdjacencyList(file, false, opt.threads); }, opt, results);
+
+        vector<pair<string, string>> meta = metadata(opt);
+        writeCsv(opt.csvFile, results, meta);
+        writeJson(opt.jsonFile, results, meta);
+        cerr << "wrote " << opt.csvFile << " and " << opt.jsonFile << endl;
+    }
+    catch (const exception& e)
+    {
+        cerr << "benchmark: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}